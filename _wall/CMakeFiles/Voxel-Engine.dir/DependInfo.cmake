@@ -0,0 +1,39 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/core/application.cpp" "CMakeFiles/Voxel-Engine.dir/src/core/application.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/core/application.cpp.o.d"
+  "/root/repo/src/core/profiler_view.cpp" "CMakeFiles/Voxel-Engine.dir/src/core/profiler_view.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/core/profiler_view.cpp.o.d"
+  "/root/repo/src/external/imgui/imgui.cpp" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui.cpp.o.d"
+  "/root/repo/src/external/imgui/imgui_draw.cpp" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_draw.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_draw.cpp.o.d"
+  "/root/repo/src/external/imgui/imgui_impl_glfw.cpp" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_impl_glfw.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_impl_glfw.cpp.o.d"
+  "/root/repo/src/external/imgui/imgui_impl_opengl3.cpp" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_impl_opengl3.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_impl_opengl3.cpp.o.d"
+  "/root/repo/src/external/imgui/imgui_tables.cpp" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_tables.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_tables.cpp.o.d"
+  "/root/repo/src/external/imgui/imgui_widgets.cpp" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_widgets.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_widgets.cpp.o.d"
+  "/root/repo/src/external/stb_image.cpp" "CMakeFiles/Voxel-Engine.dir/src/external/stb_image.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/external/stb_image.cpp.o.d"
+  "/root/repo/src/input/camera.cpp" "CMakeFiles/Voxel-Engine.dir/src/input/camera.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/input/camera.cpp.o.d"
+  "/root/repo/src/main.cpp" "CMakeFiles/Voxel-Engine.dir/src/main.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/main.cpp.o.d"
+  "/root/repo/src/render/depth_map.cpp" "CMakeFiles/Voxel-Engine.dir/src/render/depth_map.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/render/depth_map.cpp.o.d"
+  "/root/repo/src/render/gl_chunk_backend.cpp" "CMakeFiles/Voxel-Engine.dir/src/render/gl_chunk_backend.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/render/gl_chunk_backend.cpp.o.d"
+  "/root/repo/src/render/gpu_profiler.cpp" "CMakeFiles/Voxel-Engine.dir/src/render/gpu_profiler.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/render/gpu_profiler.cpp.o.d"
+  "/root/repo/src/render/gpu_timer.cpp" "CMakeFiles/Voxel-Engine.dir/src/render/gpu_timer.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/render/gpu_timer.cpp.o.d"
+  "/root/repo/src/render/mesh_arena.cpp" "CMakeFiles/Voxel-Engine.dir/src/render/mesh_arena.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/render/mesh_arena.cpp.o.d"
+  "/root/repo/src/render/skybox.cpp" "CMakeFiles/Voxel-Engine.dir/src/render/skybox.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/render/skybox.cpp.o.d"
+  "/root/repo/src/render/staging_ring.cpp" "CMakeFiles/Voxel-Engine.dir/src/render/staging_ring.cpp.o" "gcc" "CMakeFiles/Voxel-Engine.dir/src/render/staging_ring.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_wall/CMakeFiles/voxel_core.dir/DependInfo.cmake"
+  "/root/repo/_wall/include/glfw/src/CMakeFiles/glfw.dir/DependInfo.cmake"
+  "/root/repo/_wall/CMakeFiles/glad.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,45 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Voxel-Engine.dir/src/core/application.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/core/application.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/core/profiler_view.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/core/profiler_view.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_draw.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_draw.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_impl_glfw.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_impl_glfw.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_impl_opengl3.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_impl_opengl3.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_tables.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_tables.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_widgets.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/external/imgui/imgui_widgets.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/external/stb_image.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/external/stb_image.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/input/camera.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/input/camera.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/main.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/main.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/render/depth_map.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/render/depth_map.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/render/gl_chunk_backend.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/render/gl_chunk_backend.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/render/gpu_profiler.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/render/gpu_profiler.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/render/gpu_timer.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/render/gpu_timer.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/render/mesh_arena.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/render/mesh_arena.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/render/skybox.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/render/skybox.cpp.o.d"
+  "CMakeFiles/Voxel-Engine.dir/src/render/staging_ring.cpp.o"
+  "CMakeFiles/Voxel-Engine.dir/src/render/staging_ring.cpp.o.d"
+  "Voxel-Engine"
+  "Voxel-Engine.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Voxel-Engine.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
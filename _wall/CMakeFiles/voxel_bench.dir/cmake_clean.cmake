@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/voxel_bench.dir/src/tools/bench.cpp.o"
+  "CMakeFiles/voxel_bench.dir/src/tools/bench.cpp.o.d"
+  "voxel_bench"
+  "voxel_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/voxel_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
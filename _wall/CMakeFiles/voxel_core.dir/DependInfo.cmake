@@ -0,0 +1,26 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/core/flythrough.cpp" "CMakeFiles/voxel_core.dir/src/core/flythrough.cpp.o" "gcc" "CMakeFiles/voxel_core.dir/src/core/flythrough.cpp.o.d"
+  "/root/repo/src/noise/perlin_gen.cpp" "CMakeFiles/voxel_core.dir/src/noise/perlin_gen.cpp.o" "gcc" "CMakeFiles/voxel_core.dir/src/noise/perlin_gen.cpp.o.d"
+  "/root/repo/src/render/frustum.cpp" "CMakeFiles/voxel_core.dir/src/render/frustum.cpp.o" "gcc" "CMakeFiles/voxel_core.dir/src/render/frustum.cpp.o.d"
+  "/root/repo/src/render/range_allocator.cpp" "CMakeFiles/voxel_core.dir/src/render/range_allocator.cpp.o" "gcc" "CMakeFiles/voxel_core.dir/src/render/range_allocator.cpp.o.d"
+  "/root/repo/src/utils/profiler.cpp" "CMakeFiles/voxel_core.dir/src/utils/profiler.cpp.o" "gcc" "CMakeFiles/voxel_core.dir/src/utils/profiler.cpp.o.d"
+  "/root/repo/src/world/chunk_gen.cpp" "CMakeFiles/voxel_core.dir/src/world/chunk_gen.cpp.o" "gcc" "CMakeFiles/voxel_core.dir/src/world/chunk_gen.cpp.o.d"
+  "/root/repo/src/world/mesh_codec.cpp" "CMakeFiles/voxel_core.dir/src/world/mesh_codec.cpp.o" "gcc" "CMakeFiles/voxel_core.dir/src/world/mesh_codec.cpp.o.d"
+  "/root/repo/src/world/null_backend.cpp" "CMakeFiles/voxel_core.dir/src/world/null_backend.cpp.o" "gcc" "CMakeFiles/voxel_core.dir/src/world/null_backend.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
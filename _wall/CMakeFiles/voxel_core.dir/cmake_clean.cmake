@@ -0,0 +1,25 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/voxel_core.dir/src/core/flythrough.cpp.o"
+  "CMakeFiles/voxel_core.dir/src/core/flythrough.cpp.o.d"
+  "CMakeFiles/voxel_core.dir/src/noise/perlin_gen.cpp.o"
+  "CMakeFiles/voxel_core.dir/src/noise/perlin_gen.cpp.o.d"
+  "CMakeFiles/voxel_core.dir/src/render/frustum.cpp.o"
+  "CMakeFiles/voxel_core.dir/src/render/frustum.cpp.o.d"
+  "CMakeFiles/voxel_core.dir/src/render/range_allocator.cpp.o"
+  "CMakeFiles/voxel_core.dir/src/render/range_allocator.cpp.o.d"
+  "CMakeFiles/voxel_core.dir/src/utils/profiler.cpp.o"
+  "CMakeFiles/voxel_core.dir/src/utils/profiler.cpp.o.d"
+  "CMakeFiles/voxel_core.dir/src/world/chunk_gen.cpp.o"
+  "CMakeFiles/voxel_core.dir/src/world/chunk_gen.cpp.o.d"
+  "CMakeFiles/voxel_core.dir/src/world/mesh_codec.cpp.o"
+  "CMakeFiles/voxel_core.dir/src/world/mesh_codec.cpp.o.d"
+  "CMakeFiles/voxel_core.dir/src/world/null_backend.cpp.o"
+  "CMakeFiles/voxel_core.dir/src/world/null_backend.cpp.o.d"
+  "libvoxel_core.a"
+  "libvoxel_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/voxel_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/voxel_headless.dir/src/tools/headless.cpp.o"
+  "CMakeFiles/voxel_headless.dir/src/tools/headless.cpp.o.d"
+  "voxel_headless"
+  "voxel_headless.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/voxel_headless.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,32 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/chunk_render_test.cpp" "CMakeFiles/voxel_tests.dir/tests/chunk_render_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/chunk_render_test.cpp.o.d"
+  "/root/repo/tests/chunk_upload_test.cpp" "CMakeFiles/voxel_tests.dir/tests/chunk_upload_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/chunk_upload_test.cpp.o.d"
+  "/root/repo/tests/flythrough_test.cpp" "CMakeFiles/voxel_tests.dir/tests/flythrough_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/flythrough_test.cpp.o.d"
+  "/root/repo/tests/for_each_outside_test.cpp" "CMakeFiles/voxel_tests.dir/tests/for_each_outside_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/for_each_outside_test.cpp.o.d"
+  "/root/repo/tests/latency_histogram_test.cpp" "CMakeFiles/voxel_tests.dir/tests/latency_histogram_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/latency_histogram_test.cpp.o.d"
+  "/root/repo/tests/lru_cache_test.cpp" "CMakeFiles/voxel_tests.dir/tests/lru_cache_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/lru_cache_test.cpp.o.d"
+  "/root/repo/tests/mesh_codec_test.cpp" "CMakeFiles/voxel_tests.dir/tests/mesh_codec_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/mesh_codec_test.cpp.o.d"
+  "/root/repo/tests/mesh_golden_test.cpp" "CMakeFiles/voxel_tests.dir/tests/mesh_golden_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/mesh_golden_test.cpp.o.d"
+  "/root/repo/tests/pipeline_latency_test.cpp" "CMakeFiles/voxel_tests.dir/tests/pipeline_latency_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/pipeline_latency_test.cpp.o.d"
+  "/root/repo/tests/profiler_test.cpp" "CMakeFiles/voxel_tests.dir/tests/profiler_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/profiler_test.cpp.o.d"
+  "/root/repo/tests/range_allocator_test.cpp" "CMakeFiles/voxel_tests.dir/tests/range_allocator_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/range_allocator_test.cpp.o.d"
+  "/root/repo/tests/test_main.cpp" "CMakeFiles/voxel_tests.dir/tests/test_main.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/test_main.cpp.o.d"
+  "/root/repo/tests/toroidal_grid_test.cpp" "CMakeFiles/voxel_tests.dir/tests/toroidal_grid_test.cpp.o" "gcc" "CMakeFiles/voxel_tests.dir/tests/toroidal_grid_test.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_wall/CMakeFiles/voxel_core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,35 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/voxel_tests.dir/tests/chunk_render_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/chunk_render_test.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/chunk_upload_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/chunk_upload_test.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/flythrough_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/flythrough_test.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/for_each_outside_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/for_each_outside_test.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/latency_histogram_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/latency_histogram_test.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/lru_cache_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/lru_cache_test.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/mesh_codec_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/mesh_codec_test.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/mesh_golden_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/mesh_golden_test.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/pipeline_latency_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/pipeline_latency_test.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/profiler_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/profiler_test.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/range_allocator_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/range_allocator_test.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/test_main.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/test_main.cpp.o.d"
+  "CMakeFiles/voxel_tests.dir/tests/toroidal_grid_test.cpp.o"
+  "CMakeFiles/voxel_tests.dir/tests/toroidal_grid_test.cpp.o.d"
+  "voxel_tests"
+  "voxel_tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/voxel_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
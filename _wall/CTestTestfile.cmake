@@ -0,0 +1,31 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_wall
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(mesh_golden "/root/repo/_wall/voxel_tests" "mesh_golden")
+set_tests_properties(mesh_golden PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(toroidal_grid "/root/repo/_wall/voxel_tests" "toroidal_grid")
+set_tests_properties(toroidal_grid PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(for_each_outside "/root/repo/_wall/voxel_tests" "for_each_outside")
+set_tests_properties(for_each_outside PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(lru_cache "/root/repo/_wall/voxel_tests" "lru_cache")
+set_tests_properties(lru_cache PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(range_allocator "/root/repo/_wall/voxel_tests" "range_allocator")
+set_tests_properties(range_allocator PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(chunk_render "/root/repo/_wall/voxel_tests" "chunk_render")
+set_tests_properties(chunk_render PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(chunk_upload "/root/repo/_wall/voxel_tests" "chunk_upload")
+set_tests_properties(chunk_upload PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(mesh_codec "/root/repo/_wall/voxel_tests" "mesh_codec")
+set_tests_properties(mesh_codec PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(flythrough "/root/repo/_wall/voxel_tests" "flythrough")
+set_tests_properties(flythrough PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(profiler "/root/repo/_wall/voxel_tests" "profiler")
+set_tests_properties(profiler PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(latency_histogram "/root/repo/_wall/voxel_tests" "latency_histogram")
+set_tests_properties(latency_histogram PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(pipeline_latency "/root/repo/_wall/voxel_tests" "pipeline_latency")
+set_tests_properties(pipeline_latency PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;77;add_test;/root/repo/CMakeLists.txt;0;")
+subdirs("include/glfw")
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/include/glfw
+# Build directory: /root/repo/_wall/include/glfw
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("src")
+subdirs("docs")
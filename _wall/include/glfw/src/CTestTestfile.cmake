@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/include/glfw/src
+# Build directory: /root/repo/_wall/include/glfw/src
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
@@ -34,7 +34,10 @@ void loadTextureLayer(const char* path, GLint layer) {
 namespace Engine {
 
 // Constructor
-Game::Game() : camera(glm::vec3(0.0f, 32.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)) {}
+Game::Game(const BenchmarkOptions& options)
+    : camera(glm::vec3(0.0f, 32.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)),
+      chunkManager(std::make_unique<GlChunkBackend>()),
+      options(options) {}
 
 // Destructor
 Game::~Game() {
@@ -44,6 +47,17 @@ Game::~Game() {
 /* Entry point */
 
 void Game::run() {
+    if (options.enabled) {
+        flythrough = std::make_unique<Flythrough>(options);
+        if (!flythrough->load()) return;
+    }
+    if (!options.recordTo.empty()) {
+        pathRecording.open(options.recordTo);
+        if (!pathRecording) {
+            std::cerr << "[Benchmark] Could not write " << options.recordTo << '\n';
+            return;
+        }
+    }
     if (!init()) return;
     loadTextures();
     setupSkyBox();
@@ -92,6 +106,9 @@ bool Game::init() {
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
     glFrontFace(GL_CCW);
+
+    // benchmarks measure the frame, not the display's refresh rate
+    if (flythrough) glfwSwapInterval(0);
     
     return true;
 }
@@ -186,6 +203,8 @@ void Game::configureShaders() { // TODO: Move this to another file
    
 
 void Game::configureImgui() {
+    workerCount = chunkManager.getWorkerCount();
+
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
@@ -207,17 +226,79 @@ void Game::setupDepthMap() {
 }
 
 void Game::mainLoop() {
+    using Clock = std::chrono::steady_clock;
+
     std::cout << "Entering game loop" << "\n";
+    PROFILE_THREAD("Main");
     while (!glfwWindowShouldClose(window)) {
+        PROFILE_FRAME();
+        Clock::time_point frameStart = Clock::now();
         calculateFPS();
-        update();
+        gpuProfiler.beginFrame();
+        if (flythrough) gpuTimer.begin(frameIndex);
+        {
+            PROFILE_ZONE("Input");
+            update();
+        }
         render();
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        if (flythrough) gpuTimer.end();
+        gpuProfiler.endFrame();
+        std::chrono::duration<double, std::milli> cpuTime = Clock::now() - frameStart;
+        {
+            PROFILE_ZONE("Swap buffers");
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+
+        if (flythrough) {
+            FrameSample sample;
+            sample.frameMs = std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+            sample.cpuMs = cpuTime.count();
+            sample.chunksGenerated = chunkManager.getGenerationCounters().completed;
+            UploadStats uploads = chunkManager.getUploadStats();
+            sample.uploads = uploads.uploadsLastFrame;
+            sample.uploadBacklog = uploads.backlog;
+            flythrough->addFrame(sample);
+            gpuTimer.collect([this](long long frame, double ms) { flythrough->setGpuTime(frame, ms); });
+            if (flythrough->isFinished()) break;
+        }
+        frameIndex++;
     }
+
+    if (flythrough) finishBenchmark();
+}
+
+/**
+ * Waits for the outstanding GPU timings and writes the benchmark results,
+ * while the context is still alive.
+ */
+void Game::finishBenchmark() {
+    gpuTimer.collect([this](long long frame, double ms) { flythrough->setGpuTime(frame, ms); }, true);
+
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    std::string rendererName = renderer ? reinterpret_cast<const char*>(renderer) : "unknown";
+    if (flythrough->writeResults(rendererName, activeRenderDistance)) {
+        std::cout << "[Benchmark] Wrote " << options.output << ".csv and " << options.output
+                  << ".json (" << rendererName << ")\n";
+    }
+    std::ofstream pipelineReport(options.output + ".pipeline.json");
+    if (pipelineReport) {
+        chunkManager.writePipelineReport(pipelineReport);
+        std::cout << "[Benchmark] Wrote " << options.output << ".pipeline.json\n";
+    }
+#if VOXEL_PROFILING
+    // the GPU zones of the last frames are read once the GPU is done with them
+    glFinish();
+    gpuProfiler.beginFrame();
+    if (Profiler::get().writeChromeTrace(options.output + ".trace.json")) {
+        std::cout << "[Benchmark] Wrote " << options.output << ".trace.json\n";
+    }
+#endif
 }
 
 void Game::finish() {
+    if (!window) return; // run() stopped before creating the window
+    chunkManager.shutdown();
     delete skyBox;
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -258,75 +339,106 @@ void Game::update() {
         tabPressed = false;
     }
 
+    if (flythrough) {
+        // scripted camera, input only ends the run early
+        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) glfwSetWindowShouldClose(window, true);
+        CameraPose pose = flythrough->poseAt(static_cast<int>(frameIndex));
+        camera.setPose(pose.position, pose.yaw, pose.pitch);
+        return;
+    }
+
     if (!cursorEnabled) {
         camera.processInput(window, deltaTime);
     }
+    if (pathRecording.is_open()) {
+        writePose(pathRecording, {camera.Position, camera.Yaw, camera.Pitch});
+    }
 }
 
 void Game::render() {
     /* Chunk Generation */
     int playerChunk_x = static_cast<int>(std::floor(camera.Position.x / CHUNK_SIZE));
     int playerChunk_z = static_cast<int>(std::floor(camera.Position.z / CHUNK_SIZE));
-    chunkManager.update(playerChunk_x, playerChunk_z, activeRenderDistance);
-    chunkManager.uploadMesh(); // put this at top so depth map can use it
+    {
+        PROFILE_ZONE("Chunk update");
+        chunkManager.update(playerChunk_x, playerChunk_z, activeRenderDistance, camera.Front);
+    }
+    {
+        PROFILE_ZONE("Upload meshes");
+        GPU_PROFILE_ZONE(gpuProfiler, "Upload meshes");
+        chunkManager.uploadMesh(deltaTime); // put this at top so depth map can use it
+    }
 
     /* Render scene to depth map */
     // pass 1
     glm::mat4 lightSpaceMatrix = depthMap->getLightSpaceMatrix(sunDir, camera.Position);
-    depthMap->bindForWriting();
-    depthShader->useShader();
-    depthShader->setMat4("lightSpaceMatrix", lightSpaceMatrix);
-    depthShader->setMat4("terrainModel", glm::mat4(1.0f));
-    glDisable(GL_CULL_FACE); // TODO: Fix winding for faces
-    chunkManager.render();
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK); // restore for normal rendering
-    glBindFramebuffer(GL_FRAMEBUFFER, 0); // return to default framebuffer
+    {
+        PROFILE_ZONE("Depth pass");
+        GPU_PROFILE_ZONE(gpuProfiler, "Depth pass");
+        depthMap->bindForWriting();
+        depthShader->useShader();
+        depthShader->setMat4("lightSpaceMatrix", lightSpaceMatrix);
+        depthShader->setMat4("terrainModel", glm::mat4(1.0f));
+        glDisable(GL_CULL_FACE); // TODO: Fix winding for faces
+        chunkManager.renderShadow(*depthShader, lightSpaceMatrix, sunDir);
+        glEnable(GL_CULL_FACE);
+        glCullFace(GL_BACK); // restore for normal rendering
+        glBindFramebuffer(GL_FRAMEBUFFER, 0); // return to default framebuffer
+    }
     // pass 2
-    int fbWidth, fbHeight; // macOS retina displays framebuffer is double windows, safer to get framebuffer size for both
-    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
-    glViewport(0, 0, fbWidth, fbHeight);
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // background
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
     glm::mat4 view = glm::lookAt(camera.Position, camera.Position + camera.Front, camera.Up);
+    {
+        PROFILE_ZONE("Terrain pass");
+        GPU_PROFILE_ZONE(gpuProfiler, "Terrain pass");
+        int fbWidth, fbHeight; // macOS retina displays framebuffer is double windows, safer to get framebuffer size for both
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        glViewport(0, 0, fbWidth, fbHeight);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // background
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        /* Terrain */
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+        depthMap->bindForReading(1);
+        terrainShader->useShader();
+        terrainShader->setMat4("view", view); // vertices into world space
+        terrainShader->setVec3("cameraPos", camera.Position);
+        glm::mat4 terrainModel = glm::mat4(1.0f);
+        terrainShader->setMat4("terrainModel", terrainModel);
+        terrainShader->setMat4("projection", projection); // vertices into screen space
+        terrainShader->setVec3("light.position", sunDir);
+        terrainShader->setMat4("lightSpaceMatrix", lightSpaceMatrix);
+        terrainShader->setFloat("fog.fogStart", fogStart);
+        terrainShader->setFloat("fog.fogEnd", fogEnd); 
 
-    /* Terrain */
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
-    depthMap->bindForReading(1);
-    terrainShader->useShader();
-    terrainShader->setMat4("view", view); // vertices into world space
-    terrainShader->setVec3("cameraPos", camera.Position);
-    glm::mat4 terrainModel = glm::mat4(1.0f);
-    terrainShader->setMat4("terrainModel", terrainModel);
-    terrainShader->setMat4("projection", projection); // vertices into screen space
-    terrainShader->setVec3("light.position", sunDir);
-    terrainShader->setMat4("lightSpaceMatrix", lightSpaceMatrix);
-    terrainShader->setFloat("fog.fogStart", fogStart);
-    terrainShader->setFloat("fog.fogEnd", fogEnd); 
+        if (wireframe) {
+            glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        } else {
+            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        }
+
+        // render chunk
+        chunkManager.render(*terrainShader, projection * view, camera.Position);
 
-    if (wireframe) {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    } else {
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     }
 
-    // render chunk
-    chunkManager.render();
-
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-
     /* Skybox - draw last */
-    glDepthFunc(GL_LEQUAL);
-    skyBoxShader->useShader();
-    skyBoxShader->setMat4("projection", projection);
-    skyBoxShader->setMat4("view", view); // use the same view you computed above
-    skyBoxShader->setVec3("sunDir", sunDir);
-    skyBox->draw();
-    glDepthFunc(GL_LESS);
+    {
+        PROFILE_ZONE("Skybox");
+        GPU_PROFILE_ZONE(gpuProfiler, "Skybox");
+        glDepthFunc(GL_LEQUAL);
+        skyBoxShader->useShader();
+        skyBoxShader->setMat4("projection", projection);
+        skyBoxShader->setMat4("view", view); // use the same view you computed above
+        skyBoxShader->setVec3("sunDir", sunDir);
+        skyBox->draw();
+        glDepthFunc(GL_LESS);
+    }
 
-    /* Imgui */
+    /* Imgui, until the end of the frame */
+    PROFILE_ZONE("ImGui");
+    GPU_PROFILE_ZONE(gpuProfiler, "ImGui");
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -345,7 +457,6 @@ void Game::render() {
     ImGui::SliderInt("Render Distance", &renderDistance, 1, 16);
     if (ImGui::IsItemDeactivatedAfterEdit()) {
         activeRenderDistance = renderDistance;
-        chunkManager.clear();
         int fbWidth, fbHeight;
         glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
         float farPlane = (renderDistance + 1) * CHUNK_SIZE * 2.0f;
@@ -359,6 +470,100 @@ void Game::render() {
         terrainShader->setFloat("fog.fogStart", fogStart);
         terrainShader->setFloat("fog.fogEnd", fogEnd);
     }
+    ImGui::SliderInt("Workers", &workerCount, 1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+    if (ImGui::IsItemDeactivatedAfterEdit()) {
+        chunkManager.setWorkerCount(workerCount);
+    }
+    ImGui::Text("Pending chunks: %d", chunkManager.getPendingGenerations());
+    CacheStats cache = chunkManager.getCacheStats();
+    long long cacheLookups = cache.hits + cache.misses;
+    ImGui::Text("Chunk cache: %d/%d, hit rate %.1f%%, %lld re-uploaded", cache.entries, cache.capacity,
+        cacheLookups > 0 ? 100.0 * cache.hits / cacheLookups : 0.0, cache.reuploads);
+    ImGui::Text("First visible ring: %.1f ms", chunkManager.getFirstRingTime());
+    GenerationCounters jobs = chunkManager.getGenerationCounters();
+    ImGui::Text("Jobs completed: %d  cancelled: %d", jobs.completed, jobs.cancelled);
+    ImGui::Text("Jobs abandoned: %d  stale: %d", jobs.abandoned, jobs.stale);
+    UploadStats uploads = chunkManager.getUploadStats();
+    ImGui::Text("Uploads: %d (%.1f MB) in %.2f ms, budget %.2f ms", uploads.uploadsLastFrame,
+        uploads.bytesLastFrame / (1024.0f * 1024.0f), uploads.uploadMsLastFrame, uploads.budgetMs);
+    ImGui::Text("Upload backlog: %d (%.1f MB), latency avg %.1f ms, max %.1f ms", uploads.backlog,
+        uploads.backlogBytes / (1024.0f * 1024.0f), uploads.latencyAvgMs, uploads.latencyMaxMs);
+    StagingStats staging = chunkManager.getStagingStats();
+    ImGui::Text("Staging: %d mapped, %d copying, %d in flight of %d, %lld staged, %lld from CPU",
+        staging.mapped, staging.copying, staging.inFlight, staging.segments, staging.blocksStaged,
+        staging.blocksRejected);
+    ImGui::Text("Triangles: %lld", chunkManager.getResidentTriangles());
+    PassStats terrainStats = chunkManager.getTerrainStats();
+    PassStats shadowStats = chunkManager.getShadowStats();
+    ImGui::Text("Chunks drawn: %d  culled: %d", terrainStats.chunksDrawn, terrainStats.chunksCulled);
+    ImGui::Text("Shadow chunks drawn: %d  culled: %d", shadowStats.chunksDrawn, shadowStats.chunksCulled);
+    ImGui::Text("Draw calls: terrain %d (%d ranges), shadow %d (%d ranges)", terrainStats.drawCalls,
+        terrainStats.drawRanges, shadowStats.drawCalls, shadowStats.drawRanges);
+    ImGui::Text("Backface skipped triangles: terrain %lld, shadow %lld",
+        terrainStats.trianglesSkipped, shadowStats.trianglesSkipped);
+    bool packedVertices = chunkManager.getVertexFormat() == VertexFormat::Packed;
+    if (ImGui::Checkbox("Packed vertices", &packedVertices)) {
+        chunkManager.setVertexFormat(packedVertices ? VertexFormat::Packed : VertexFormat::Float);
+    }
+    MeshMemory meshMemory = chunkManager.getMeshMemory();
+    ImGui::Text("CPU meshes: %.1f MB queued, %.1f MB compressed",
+        meshMemory.queuedBytes / (1024.0f * 1024.0f), meshMemory.compressedBytes / (1024.0f * 1024.0f));
+    ImGui::Text("GPU meshes: %.1f MB in %.1f MB arena, %.1f MB indices, %.1f MB staging",
+        meshMemory.gpuBytes / (1024.0f * 1024.0f), meshMemory.arenaBytes / (1024.0f * 1024.0f),
+        meshMemory.indexBytes / (1024.0f * 1024.0f), meshMemory.stagingBytes / (1024.0f * 1024.0f));
+    ImGui::Text("Float layout: %.1f MB, packed layout: %.1f MB",
+        meshMemory.floatLayoutBytes / (1024.0f * 1024.0f), meshMemory.packedLayoutBytes / (1024.0f * 1024.0f));
+    bool compressedCopies = chunkManager.getCompressedCopies();
+    if (ImGui::Checkbox("Compressed copies (cache off GPU)", &compressedCopies)) {
+        chunkManager.setCompressedCopies(compressedCopies);
+    }
+    ArenaStats arenaStats = chunkManager.getArenaStats();
+    ImGui::Text("Mesh arena: %d pages, %.1f / %.1f MB used, %.1f MB fragmented, %d defrags",
+        arenaStats.pages, arenaStats.usedBytes / (1024.0f * 1024.0f),
+        arenaStats.capacityBytes / (1024.0f * 1024.0f),
+        arenaStats.fragmentedBytes / (1024.0f * 1024.0f), arenaStats.defragmentations);
+    ImGui::Separator();
+    if (ImGui::CollapsingHeader("Chunk pipeline")) {
+        PipelineCounters pipeline = chunkManager.getPipelineCounters();
+        ImGui::Text("Queued: %d  in flight: %d  awaiting upload: %d", pipeline.queued,
+            pipeline.inFlight, pipeline.awaitingUpload);
+        ImGui::Text("Resident: %d  evicted: %lld  worker utilization: %.0f%%", pipeline.resident,
+            pipeline.evicted, pipeline.workerUtilization * 100.0f);
+        if (ImGui::BeginTable("pipeline_latency", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Stage");
+            ImGui::TableSetupColumn("Chunks");
+            ImGui::TableSetupColumn("p50 ms");
+            ImGui::TableSetupColumn("p99 ms");
+            ImGui::TableSetupColumn("max ms");
+            ImGui::TableHeadersRow();
+            for (int i = 0; i < PIPELINE_STAGE_COUNT; i++) {
+                PipelineStage stage = static_cast<PipelineStage>(i);
+                const LatencyHistogram& latency = chunkManager.getStageLatency(stage);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(pipelineStageName(stage));
+                ImGui::TableNextColumn();
+                ImGui::Text("%lld", latency.count());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", latency.percentile(50.0) * 1e-3);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", latency.percentile(99.0) * 1e-3);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", latency.max() * 1e-3);
+            }
+            ImGui::EndTable();
+        }
+        if (ImGui::Button("Reset latencies")) chunkManager.resetStageLatency();
+        ImGui::SameLine();
+        if (ImGui::Button("Dump to chunk_pipeline.json")) {
+            std::ofstream report("chunk_pipeline.json");
+            if (report) chunkManager.writePipelineReport(report);
+            else std::cerr << "[Pipeline] Could not write chunk_pipeline.json\n";
+        }
+    }
+    if (ImGui::CollapsingHeader("Profiler")) {
+        profilerView.draw();
+    }
 
     ImGui::End();
     ImGui::Render();
@@ -2,7 +2,9 @@
  * Handles main application rendering using glfw.
  */
 
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <stdio.h>
 #include <unordered_set>
 #include <glad/glad.h>
@@ -23,6 +25,7 @@
 
 // chunk generation
 #include "../world/chunk_gen.hpp"
+#include "../render/gl_chunk_backend.hpp"
 
 // camera helpers
 #include "../input/camera.hpp"
@@ -33,6 +36,15 @@
 // shadow mapping
 #include "../render/depth_map.hpp"
 
+// benchmark mode
+#include "../render/gpu_timer.hpp"
+#include "flythrough.hpp"
+
+// profiling
+#include "../render/gpu_profiler.hpp"
+#include "../utils/profiler.hpp"
+#include "profiler_view.hpp"
+
 namespace Engine {
 
 inline constexpr unsigned int SCREEN_WIDTH = 800;
@@ -71,6 +83,17 @@ class Game {
         /* World */
         ChunkManager chunkManager;
 
+        /* Benchmark mode, flythrough is only set while one runs */
+        BenchmarkOptions options;
+        std::unique_ptr<Flythrough> flythrough;
+        GpuTimer gpuTimer;
+        std::ofstream pathRecording;
+        long long frameIndex = 0;
+
+        /* Profiler, GPU zones of the passes and the Debug window timeline */
+        GpuProfiler gpuProfiler;
+        ProfilerView profilerView;
+
         /* Loop functions */
         bool init();
         void loadTextures();
@@ -79,6 +102,7 @@ class Game {
         void setupSkyBox();
         void setupDepthMap();
         void mainLoop();
+        void finishBenchmark();
         void finish();
 
         void update();
@@ -117,11 +141,12 @@ class Game {
         /* render / chunks */
         int renderDistance = RENDER_DISTANCE;
         int activeRenderDistance = RENDER_DISTANCE;
+        int workerCount = 1;
 
     public:
-        GLFWwindow* window;
+        GLFWwindow* window = nullptr;
 
-        Game();
+        explicit Game(const BenchmarkOptions& options = BenchmarkOptions());
         ~Game();
 
         void run();
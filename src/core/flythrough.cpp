@@ -0,0 +1,272 @@
+#include "flythrough.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+/*
+Process
+
+1. Paths advance by a fixed timestep per frame (1/60 s), whatever the real
+   frame time, and the teleport targets come from an mt19937 seeded from the
+   command line, so a path is the same on every machine and every run.
+
+2. The game records one FrameSample per frame. GPU times arrive a few frames
+   late from the timer queries and are filled into their frame afterwards.
+
+3. At exit the samples go to a CSV, one row per frame, and a JSON summary with
+   average, p50, p95, p99 and max of the frame, CPU and GPU times plus the
+   streaming totals. Percentiles use the nearest rank of the sorted samples.
+*/
+
+namespace Engine {
+
+/** Timestep of the scripted paths, independent of the real frame time */
+static constexpr float PATH_TIMESTEP = 1.0f / 60.0f;
+
+/** Frames a scripted path runs for unless --frames says otherwise */
+static constexpr int DEFAULT_FRAMES = 1800;
+
+/** Camera height and downward pitch of the scripted paths, above the terrain */
+static constexpr float FLIGHT_HEIGHT = 40.0f;
+static constexpr float FLIGHT_PITCH = -15.0f;
+
+/** Blocks per second along the sprint and spiral paths */
+static constexpr float SPRINT_SPEED = 32.0f;
+static constexpr float SPIRAL_SPEED = 24.0f;
+/** Spiral radius gained per radian, about three chunks per turn */
+static constexpr float SPIRAL_SPACING = 8.0f;
+
+/** Frames between teleports, the extent of the jumps and the turn rate between */
+static constexpr int TELEPORT_INTERVAL = 90;
+static constexpr float TELEPORT_RANGE = 4096.0f;
+static constexpr float TELEPORT_TURN_SPEED = 30.0f;
+
+/** Frames slower than this count as hitches, twice a 60 Hz frame */
+static constexpr double HITCH_MS = 1000.0 / 30.0;
+
+static const char* pathName(FlightPath path) {
+    switch (path) {
+        case FlightPath::Sprint: return "sprint";
+        case FlightPath::Spiral: return "spiral";
+        case FlightPath::Teleport: return "teleport";
+        case FlightPath::Recorded: return "recorded";
+    }
+    return "";
+}
+
+void printUsage() {
+    std::cerr << "usage: Voxel-Engine [--record FILE]\n"
+                 "       Voxel-Engine --bench sprint|spiral|teleport|FILE [--frames N]"
+                 " [--seed N] [--out PREFIX]\n";
+}
+
+bool parseCommandLine(int argc, char** argv, BenchmarkOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--bench" && hasValue) {
+            std::string path = argv[++i];
+            options.enabled = true;
+            if (path == "sprint") {
+                options.path = FlightPath::Sprint;
+            } else if (path == "spiral") {
+                options.path = FlightPath::Spiral;
+            } else if (path == "teleport") {
+                options.path = FlightPath::Teleport;
+            } else {
+                options.path = FlightPath::Recorded;
+                options.recording = path;
+            }
+        } else if (arg == "--frames" && hasValue) {
+            options.frames = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--out" && hasValue) {
+            options.output = argv[++i];
+        } else if (arg == "--record" && hasValue) {
+            options.recordTo = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return options.frames >= 0 && !(options.enabled && !options.recordTo.empty());
+}
+
+void writePose(std::ostream& out, const CameraPose& pose) {
+    out << pose.position.x << ',' << pose.position.y << ',' << pose.position.z << ','
+        << pose.yaw << ',' << pose.pitch << '\n';
+}
+
+Flythrough::Flythrough(const BenchmarkOptions& options) : options(options) {
+    if (options.path != FlightPath::Teleport) return;
+
+    std::mt19937 random(options.seed);
+    std::uniform_real_distribution<float> offset(-TELEPORT_RANGE, TELEPORT_RANGE);
+    std::uniform_real_distribution<float> heading(0.0f, 360.0f);
+    int jumps = frameCount() / TELEPORT_INTERVAL + 1;
+    for (int i = 0; i < jumps; i++) {
+        CameraPose target;
+        target.position = glm::vec3(offset(random), FLIGHT_HEIGHT, offset(random));
+        target.yaw = heading(random);
+        target.pitch = FLIGHT_PITCH;
+        teleports.push_back(target);
+    }
+}
+
+bool Flythrough::load() {
+    if (options.path != FlightPath::Recorded) return true;
+
+    std::ifstream file(options.recording);
+    if (!file) {
+        std::cerr << "[Benchmark] Could not read " << options.recording << '\n';
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        CameraPose pose;
+        if (fields >> pose.position.x >> pose.position.y >> pose.position.z >> pose.yaw >> pose.pitch) {
+            recorded.push_back(pose);
+        }
+    }
+    if (recorded.empty()) {
+        std::cerr << "[Benchmark] No poses in " << options.recording << '\n';
+        return false;
+    }
+    return true;
+}
+
+int Flythrough::frameCount() const {
+    if (options.frames > 0) return options.frames;
+    if (options.path == FlightPath::Recorded) return static_cast<int>(recorded.size());
+    return DEFAULT_FRAMES;
+}
+
+CameraPose Flythrough::poseAt(int frame) const {
+    float time = frame * PATH_TIMESTEP;
+    CameraPose pose;
+    pose.pitch = FLIGHT_PITCH;
+
+    switch (options.path) {
+        case FlightPath::Sprint:
+            pose.position = glm::vec3(time * SPRINT_SPEED, FLIGHT_HEIGHT, 0.0f);
+            pose.yaw = 0.0f;
+            break;
+        case FlightPath::Spiral: {
+            // arc length of r = a * angle is about a * angle^2 / 2
+            float angle = std::sqrt(2.0f * SPIRAL_SPEED * time / SPIRAL_SPACING);
+            float radius = SPIRAL_SPACING * angle;
+            pose.position = glm::vec3(radius * std::cos(angle), FLIGHT_HEIGHT,
+                                      radius * std::sin(angle));
+            glm::vec2 tangent(std::cos(angle) - angle * std::sin(angle),
+                              std::sin(angle) + angle * std::cos(angle));
+            pose.yaw = glm::degrees(std::atan2(tangent.y, tangent.x));
+            break;
+        }
+        case FlightPath::Teleport: {
+            // frames past the end stay at the last target
+            int jump = std::min(frame / TELEPORT_INTERVAL, static_cast<int>(teleports.size()) - 1);
+            const CameraPose& target = teleports[jump];
+            pose.position = target.position;
+            pose.yaw = target.yaw + (frame % TELEPORT_INTERVAL) * PATH_TIMESTEP * TELEPORT_TURN_SPEED;
+            break;
+        }
+        case FlightPath::Recorded:
+            pose = recorded[std::min(frame, static_cast<int>(recorded.size()) - 1)];
+            break;
+    }
+    return pose;
+}
+
+void Flythrough::addFrame(const FrameSample& sample) {
+    samples.push_back(sample);
+}
+
+void Flythrough::setGpuTime(long long frame, double milliseconds) {
+    if (frame >= 0 && frame < static_cast<long long>(samples.size())) {
+        samples[frame].gpuMs = milliseconds;
+    }
+}
+
+/**
+ * Writes {"avg", "p50", "p95", "p99", "max"} of the values, or null without any.
+ */
+static void writeDistribution(std::ostream& out, std::vector<double> values) {
+    if (values.empty()) {
+        out << "null";
+        return;
+    }
+    std::sort(values.begin(), values.end());
+    auto percentile = [&values](double p) {
+        std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * values.size()));
+        return values[std::max<std::size_t>(rank, 1) - 1];
+    };
+    double sum = 0.0;
+    for (double value : values) sum += value;
+
+    out << "{\"samples\": " << values.size() << ", \"avg\": " << sum / values.size()
+        << ", \"p50\": " << percentile(50.0) << ", \"p95\": " << percentile(95.0)
+        << ", \"p99\": " << percentile(99.0) << ", \"max\": " << values.back() << "}";
+}
+
+static std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+bool Flythrough::writeResults(const std::string& renderer, int renderDistance) const {
+    std::ofstream csv(options.output + ".csv");
+    std::ofstream json(options.output + ".json");
+    if (!csv || !json) {
+        std::cerr << "[Benchmark] Could not write " << options.output << ".csv/.json\n";
+        return false;
+    }
+
+    std::vector<double> frameTimes, cpuTimes, gpuTimes;
+    int hitches = 0;
+    int maxBacklog = 0;
+    csv << "frame,frame_ms,cpu_ms,gpu_ms,chunks_generated,uploads,upload_backlog\n";
+    for (std::size_t i = 0; i < samples.size(); i++) {
+        const FrameSample& sample = samples[i];
+        csv << i << ',' << sample.frameMs << ',' << sample.cpuMs << ',';
+        if (sample.gpuMs >= 0.0) csv << sample.gpuMs;
+        csv << ',' << sample.chunksGenerated << ',' << sample.uploads << ','
+            << sample.uploadBacklog << '\n';
+
+        frameTimes.push_back(sample.frameMs);
+        cpuTimes.push_back(sample.cpuMs);
+        if (sample.gpuMs >= 0.0) gpuTimes.push_back(sample.gpuMs);
+        if (sample.frameMs > HITCH_MS) hitches++;
+        maxBacklog = std::max(maxBacklog, sample.uploadBacklog);
+    }
+
+    json << "{\n";
+    json << "  \"path\": \"" << pathName(options.path) << "\",\n";
+    json << "  \"frames\": " << samples.size() << ",\n";
+    json << "  \"seed\": " << options.seed << ",\n";
+    json << "  \"render_distance\": " << renderDistance << ",\n";
+    json << "  \"renderer\": \"" << escapeJson(renderer) << "\",\n";
+    json << "  \"frame_ms\": ";
+    writeDistribution(json, frameTimes);
+    json << ",\n  \"cpu_ms\": ";
+    writeDistribution(json, cpuTimes);
+    json << ",\n  \"gpu_ms\": ";
+    writeDistribution(json, gpuTimes);
+    json << ",\n  \"hitches_over_33ms\": " << hitches << ",\n";
+    json << "  \"chunks_generated\": " << (samples.empty() ? 0 : samples.back().chunksGenerated) << ",\n";
+    json << "  \"max_upload_backlog\": " << maxBacklog << "\n";
+    json << "}\n";
+    return true;
+}
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+enum class FlightPath {
+    /** Straight line along +x at a fixed speed */
+    Sprint,
+    /** Outward spiral around the spawn, constant speed along the curve */
+    Spiral,
+    /** Jumps to seeded random spots, looking around in between */
+    Teleport,
+    /** Poses read from a file written with --record */
+    Recorded
+};
+
+/**
+ * @brief Camera position and orientation for one frame, angles in degrees.
+ */
+struct CameraPose {
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+/**
+ * @brief Command line settings of the game.
+ */
+struct BenchmarkOptions {
+    /** Fly the camera along a path instead of reading input */
+    bool enabled = false;
+    FlightPath path = FlightPath::Sprint;
+    /** Pose file played back by FlightPath::Recorded */
+    std::string recording;
+    /** Frames to run, 0 for the path's default */
+    int frames = 0;
+    unsigned int seed = 1;
+    /** Results go to <output>.csv and <output>.json */
+    std::string output = "flythrough";
+    /** Outside benchmarks, writes the flown path to this file every frame */
+    std::string recordTo;
+};
+
+/**
+ * @return False if an argument is unknown or malformed.
+ */
+bool parseCommandLine(int argc, char** argv, BenchmarkOptions& options);
+void printUsage();
+
+/**
+ * @brief Appends a pose as one line of a recording.
+ */
+void writePose(std::ostream& out, const CameraPose& pose);
+
+/**
+ * @brief Measurements of one benchmark frame.
+ */
+struct FrameSample {
+    /** Whole frame, buffer swap included */
+    double frameMs = 0.0;
+    /** Update and render up to the buffer swap */
+    double cpuMs = 0.0;
+    /** GL_TIME_ELAPSED of the frame's commands, -1 if it was not measured */
+    double gpuMs = -1.0;
+    /** Generation jobs completed since the start */
+    int chunksGenerated = 0;
+    int uploads = 0;
+    int uploadBacklog = 0;
+};
+
+/**
+ * @class Flythrough
+ * @brief Deterministic camera path of a benchmark run and the frame samples
+ * measured along it.
+ *
+ * Poses depend only on the frame index and the seed, never on measured frame
+ * times, so every run covers the same ground in the same number of frames.
+ */
+class Flythrough {
+    public:
+        explicit Flythrough(const BenchmarkOptions& options);
+
+        /**
+         * @brief Reads the recording of a recorded path.
+         * @return False if it is missing or holds no pose.
+         */
+        bool load();
+
+        int frameCount() const;
+        CameraPose poseAt(int frame) const;
+
+        void addFrame(const FrameSample& sample);
+        void setGpuTime(long long frame, double milliseconds);
+        bool isFinished() const { return static_cast<int>(samples.size()) >= frameCount(); }
+
+        /**
+         * @brief Writes every sample to <output>.csv and the percentiles to
+         * <output>.json.
+         * @param renderer GL_RENDERER string, tells software runs apart.
+         */
+        bool writeResults(const std::string& renderer, int renderDistance) const;
+
+    private:
+        BenchmarkOptions options;
+        std::vector<CameraPose> recorded;
+        /* Targets of the teleport path, one per jump */
+        std::vector<CameraPose> teleports;
+        std::vector<FrameSample> samples;
+};
+
+}
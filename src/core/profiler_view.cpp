@@ -0,0 +1,135 @@
+#include "profiler_view.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include "imgui/imgui.h"
+#include "../utils/profiler.hpp"
+
+namespace Engine {
+
+/** Height of the frame time bars, and the frame time that fills it */
+static constexpr float BARS_HEIGHT = 48.0f;
+static constexpr double BARS_SCALE_MS = 1000.0 / 30.0;
+
+static ImU32 zoneColor(const char* name) {
+    // hashed on the text, names are literals that may repeat across files
+    std::size_t hash = std::hash<std::string>()(name);
+    float hue = static_cast<float>(hash % 360) / 360.0f;
+    return ImColor::HSV(hue, 0.45f, 0.8f);
+}
+
+void ProfilerView::draw() {
+#if !VOXEL_PROFILING
+    ImGui::Text("Profiler compiled out (VOXEL_PROFILING=OFF)");
+#else
+    // file the export button writes, in the working directory
+    static const char* TRACE_PATH = "profile_trace.json";
+
+    if (ImGui::Checkbox("Pause", &paused) && paused) {
+        frozenFrames = Profiler::get().getFrames();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Follow latest")) selectedFrame = 0;
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome trace")) {
+        exportStatus = Profiler::get().writeChromeTrace(TRACE_PATH)
+            ? std::string("wrote ") + TRACE_PATH : std::string("could not write ") + TRACE_PATH;
+    }
+    if (!exportStatus.empty()) {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(exportStatus.c_str());
+    }
+
+    std::vector<long long> frames = paused ? frozenFrames : Profiler::get().getFrames();
+    // the last start belongs to the frame in progress
+    int complete = static_cast<int>(frames.size()) - 1;
+    if (complete < 1) return;
+
+    int shown = std::max(0, complete - LIVE_LAG);
+    if (selectedFrame != 0) {
+        auto found = std::find(frames.begin(), frames.end(), selectedFrame);
+        if (found != frames.end() && found - frames.begin() < complete) {
+            shown = static_cast<int>(found - frames.begin());
+        }
+    }
+
+    drawFrameBars(frames, shown);
+    ImGui::Text("Frame %.2f ms", (frames[shown + 1] - frames[shown]) * 1e-6);
+    drawTimeline(frames[shown], frames[shown + 1]);
+#endif
+}
+
+void ProfilerView::drawFrameBars(const std::vector<long long>& frames, int shown) {
+    int complete = static_cast<int>(frames.size()) - 1;
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+    float barWidth = width / static_cast<float>(complete);
+
+    ImGui::InvisibleButton("frame_bars", ImVec2(width, BARS_HEIGHT));
+    bool hovered = ImGui::IsItemHovered();
+    bool clicked = ImGui::IsItemClicked();
+    float mouseX = ImGui::GetIO().MousePos.x;
+
+    drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + BARS_HEIGHT),
+                            IM_COL32(20, 20, 20, 200));
+    for (int i = 0; i < complete; i++) {
+        double ms = (frames[i + 1] - frames[i]) * 1e-6;
+        float height = static_cast<float>(std::min(ms / BARS_SCALE_MS, 1.0)) * BARS_HEIGHT;
+        float left = origin.x + i * barWidth;
+        ImU32 color = ms > BARS_SCALE_MS ? IM_COL32(230, 70, 60, 255)
+                    : ms > BARS_SCALE_MS / 2.0 ? IM_COL32(230, 190, 60, 255)
+                    : IM_COL32(90, 190, 90, 255);
+        if (i == shown) color = IM_COL32(255, 255, 255, 255);
+        drawList->AddRectFilled(ImVec2(left, origin.y + BARS_HEIGHT - height),
+                                ImVec2(left + std::max(barWidth - 1.0f, 1.0f), origin.y + BARS_HEIGHT),
+                                color);
+
+        if (hovered && mouseX >= left && mouseX < left + barWidth) {
+            ImGui::SetTooltip("%.2f ms", ms);
+            if (clicked) selectedFrame = frames[i];
+        }
+    }
+}
+
+void ProfilerView::drawTimeline(long long fromNs, long long toNs) {
+    float rowHeight = ImGui::GetTextLineHeight() + 2.0f;
+    double span = static_cast<double>(std::max(toNs - fromNs, 1LL));
+
+    for (const TrackSnapshot& track : Profiler::get().snapshot(fromNs, toNs)) {
+        if (track.events.empty()) continue;
+        int rows = 0;
+        for (const ProfileEvent& event : track.events) rows = std::max(rows, event.depth + 1);
+
+        ImGui::TextUnformatted(track.name.c_str());
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+        ImVec2 end(origin.x + width, origin.y + rows * rowHeight);
+        ImGui::Dummy(ImVec2(width, rows * rowHeight));
+
+        drawList->PushClipRect(origin, end, true);
+        drawList->AddRectFilled(origin, end, IM_COL32(20, 20, 20, 200));
+        for (const ProfileEvent& event : track.events) {
+            float left = origin.x + static_cast<float>((event.startNs - fromNs) / span) * width;
+            float right = origin.x + static_cast<float>((event.endNs - fromNs) / span) * width;
+            right = std::max(right, left + 1.0f);
+            float top = origin.y + event.depth * rowHeight;
+            ImVec2 min(left, top);
+            ImVec2 max(right, top + rowHeight - 1.0f);
+            drawList->AddRectFilled(min, max, zoneColor(event.name));
+
+            if (ImGui::CalcTextSize(event.name).x + 4.0f < right - left) {
+                drawList->AddText(ImVec2(std::max(left, origin.x) + 2.0f, top + 1.0f),
+                                  IM_COL32(0, 0, 0, 255), event.name);
+            }
+            if (ImGui::IsMouseHoveringRect(min, max)) {
+                ImGui::SetTooltip("%s\n%.3f ms", event.name, (event.endNs - event.startNs) * 1e-6);
+            }
+        }
+        drawList->PopClipRect();
+    }
+}
+
+}
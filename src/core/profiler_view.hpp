@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+/**
+ * @class ProfilerView
+ * @brief Frame time bars and a per thread zone timeline of the Profiler,
+ * drawn into the current ImGui window.
+ *
+ * The bars show the last Profiler::FRAME_HISTORY frames; clicking one shows
+ * its zones below, one lane per track and one row per nesting depth. Without
+ * a selection the view follows the frame LIVE_LAG frames back, whose GPU
+ * results have arrived by then.
+ */
+class ProfilerView {
+    public:
+        void draw();
+
+    private:
+        static constexpr int LIVE_LAG = 4;
+
+        void drawFrameBars(const std::vector<long long>& frames, int shown);
+        void drawTimeline(long long fromNs, long long toNs);
+
+        bool paused = false;
+        /* Frame starts kept while paused */
+        std::vector<long long> frozenFrames;
+        /* Start of the selected frame, 0 to follow the live frame */
+        long long selectedFrame = 0;
+        std::string exportStatus;
+};
+
+}
@@ -37,6 +37,13 @@ void Camera::processInput(GLFWwindow* window, float deltaTime) {
     if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) Position -= speed * Up;
 }
 
+void Camera::setPose(const glm::vec3& position, float yaw, float pitch) {
+    Position = position;
+    Yaw = yaw;
+    Pitch = glm::clamp(pitch, -89.0f, 89.0f);
+    updateCameraVectors();
+}
+
 void Camera::mouseCallBack(GLFWwindow* window, double xPos, double yPos) {
     if (firstLoad) {
         lastMouseX = xPos;
@@ -38,6 +38,11 @@ public:
            float pitch = PITCH);
 
     void processInput(GLFWwindow* window, float deltaTime);
+    /**
+     * @brief Places the camera directly, angles in degrees. Used by scripted
+     * flythroughs instead of input.
+     */
+    void setPose(const glm::vec3& position, float yaw, float pitch);
     void mouseCallBack(GLFWwindow* window, double xPos, double yPos);
 };
 
@@ -1,8 +1,13 @@
 #include "core/application.hpp"
 
-int main() {
-     
-    Engine::Game app;
+int main(int argc, char** argv) {
+    Engine::BenchmarkOptions options;
+    if (!Engine::parseCommandLine(argc, argv, options)) {
+        Engine::printUsage();
+        return 1;
+    }
+
+    Engine::Game app(options);
     app.run();
 
     return 0;
@@ -1,9 +1,14 @@
 #define STB_PERLIN_IMPLEMENTATION
 #include <stb_perlin.h>
 #include "perlin_gen.hpp"
+#include "../world/voxel_grid.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <vector>
-#include <random>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 #include <glm/mat4x4.hpp>
 #include <glm/glm.hpp>
 
@@ -24,7 +29,17 @@ texture and combine them.
 https://www.youtube.com/watch?v=4xs66m1Of4A&t=410s
 
 Optimizations
-A 1D vector hash is used to optimize storage and lookup. (to implement)
+Blocks are stored in a flat VoxelGrid with a one voxel border of air, so
+neighbor lookups need no bounds checks. Each worker thread reuses its own grid.
+
+Meshing works on bit masks rather than per cell grids. Every column becomes a
+64-bit mask of solid blocks, exposed faces fall out of shifts and ANDs against
+the neighboring column, and quads are grown with count-trailing-zeros (see
+greedyMergePlane). Top and bottom faces are merged in horizontal slices, side
+faces in their own vertical planes so walls merge across their height.
+
+Quads are grouped by direction in Face order (see ChunkMesh::faceFirstQuad),
+so the renderer can skip whole directions facing away from the viewer.
 
 */
 
@@ -40,8 +55,10 @@ const unsigned int CHUNK_HEIGHT = 32;
 constexpr float airThreshold = 0.0f;
 
 // implement block IDs for different types of blocks
-const int airID = 0;
-const int solidID = 1;
+const BlockID airID = 0;
+const BlockID solidID = 1;
+
+using ChunkVoxels = VoxelGrid<CHUNK_WIDTH, CHUNK_LENGTH, CHUNK_HEIGHT>;
 
 // textures IDs for different faces
 const float defaultTex = 0;
@@ -52,87 +69,287 @@ const float flowerTex = 3;
 // chance of flower tile generating
 constexpr float chance = 0.06f;
 
-// greedy merge helper - finds largest rectangle in mask and emits faces
-// mask value of -1 means no face, otherwise stores texID
-using Mask2D = std::vector<std::vector<float>>;
-using Used2D = std::vector<std::vector<bool>>;
+// one bit per block in a column, bit k = block at height k
+using ColumnMask = std::uint64_t;
+// one bit per block along z in a row of a horizontal slice
+using RowMask = std::uint32_t;
 
-static void greedyMergeXZ(
-    std::vector<Vertex>& v,
-    const Mask2D& mask,
-    int width, int depth, int k,
-    int chunkX, int chunkZ,
-    void (*emitFace)(std::vector<Vertex>&, int, int, int, float, int, int)
-) {
-    Used2D used(width, std::vector<bool>(depth, false));
+static_assert(CHUNK_HEIGHT < 64, "a column must fit in a ColumnMask");
+static_assert(CHUNK_LENGTH < 32, "a slice row must fit in a RowMask");
+
+// column masks including the one voxel border around the chunk
+using ColumnMasks = ColumnMask[CHUNK_WIDTH + 2][CHUNK_LENGTH + 2];
+// face masks split by texture, see FaceTextures
+using FaceMasks = ColumnMask[2][CHUNK_WIDTH][CHUNK_LENGTH];
+// one slice per height, one row mask per x, split by texture
+using SliceMasks = RowMask[CHUNK_HEIGHT][2][CHUNK_WIDTH];
 
-    for (int i = 0; i < width; i++) {
-        for (int j = 0; j < depth; j++) {
-            if (used[i][j] || mask[i][j] < 0.0f) continue;
+using FaceEmitter = void (*)(std::vector<Vertex>&, int, int, int, float, int, int);
+
+/**
+ * Border columns diagonal to the chunk, side faces never look at them.
+ */
+static inline bool isCorner(int x, int z) {
+    bool borderX = x < 0 || x >= (int)CHUNK_WIDTH;
+    bool borderZ = z < 0 || z >= (int)CHUNK_LENGTH;
+    return borderX && borderZ;
+}
+
+static inline int countTrailingZeros(std::uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+static inline int countLeadingZeros(std::uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, bits);
+    return 63 - static_cast<int>(index);
+#else
+    return __builtin_clzll(bits);
+#endif
+}
+
+/**
+ * Deterministic per-block random value in [0, 1). Hashing the block position
+ * instead of drawing from a random engine means a chunk meshes identically
+ * every time it is generated.
+ */
+static float blockRandom(int x, int y, int z) {
+    std::uint32_t h = static_cast<std::uint32_t>(x) * 73856093u ^
+                      static_cast<std::uint32_t>(y) * 19349663u ^
+                      static_cast<std::uint32_t>(z) * 83492791u;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return static_cast<float>(h >> 8) * (1.0f / 16777216.0f);
+}
 
-            float texID = mask[i][j];
+/**
+ * Binary greedy merge of a single plane of faces. Each row is a bit mask of
+ * faces, with a separate set of rows per texture. Quads start at the lowest
+ * remaining bit, grow across rows while the next row has the same bit set and
+ * then along the bits over the run every covered row shares.
+ *
+ * Faces are visited row by row, lowest bit first, the same order as a cell by
+ * cell scan of the plane.
+ *
+ * @param mergeRows Allow quads to span several rows.
+ * @param mergeBits Allow quads to span several bits.
+ * @param emit Called as emit(texture, row, bit, rows spanned, bits spanned).
+ */
+template <typename Mask, int RowCount, typename Emit>
+static void greedyMergePlane(
+    Mask (&rows)[2][RowCount],
+    bool mergeRows, bool mergeBits,
+    Emit emit
+) {
+    for (int i = 0; i < RowCount; i++) {
+        while (rows[0][i] | rows[1][i]) {
+            int j = countTrailingZeros(rows[0][i] | rows[1][i]);
+            int t = (rows[0][i] >> j) & 1u ? 0 : 1;
+            Mask bit = Mask(1) << j;
 
-            // expand width along x
+            // expand across rows
             int w = 1;
-            while (i + w < width && !used[i + w][j] && mask[i + w][j] == texID)
+            while (mergeRows && i + w < RowCount && (rows[t][i + w] & bit))
                 w++;
 
-            // expand depth along z
+            // expand along the bits shared by every covered row
             int d = 1;
-            bool canExpand = true;
-            while (j + d < depth && canExpand) {
-                for (int di = 0; di < w; di++) {
-                    if (used[i + di][j + d] || mask[i + di][j + d] != texID) {
-                        canExpand = false;
-                        break;
-                    }
-                }
-                if (canExpand) d++;
+            if (mergeBits) {
+                Mask common = rows[t][i];
+                for (int di = 1; di < w; di++)
+                    common &= rows[t][i + di];
+                d = countTrailingZeros(~static_cast<std::uint64_t>(common >> j));
             }
 
             // mark used
+            Mask span = ((Mask(1) << d) - 1) << j;
             for (int di = 0; di < w; di++)
-                for (int dj = 0; dj < d; dj++)
-                    used[i + di][j + dj] = true;
+                rows[t][i + di] &= ~span;
 
+            emit(t, i, j, w, d);
+        }
+    }
+}
+
+/**
+ * Transposes per column face masks of a horizontal face direction into one
+ * slice per height (rows along x, bits along z) and greedily merges every
+ * non-empty slice.
+ */
+static void meshHorizontalFaces(
+    std::vector<Vertex>& v,
+    const FaceMasks& faces,
+    const float (&texIDs)[2],
+    int chunkX, int chunkZ,
+    FaceEmitter emitFace
+) {
+    SliceMasks slices = {};
+    ColumnMask occupied = 0;
+    for (int t = 0; t < 2; t++) {
+        for (int i = 0; i < (int)CHUNK_WIDTH; i++) {
+            for (int j = 0; j < (int)CHUNK_LENGTH; j++) {
+                ColumnMask bits = faces[t][i][j];
+                occupied |= bits;
+                while (bits) {
+                    int k = countTrailingZeros(bits);
+                    slices[k][t][i] |= RowMask(1) << j;
+                    bits &= bits - 1;
+                }
+            }
+        }
+    }
+
+    while (occupied) {
+        int k = countTrailingZeros(occupied);
+        greedyMergePlane(slices[k], true, true, [&](int t, int i, int j, int w, int d) {
             int worldX = i + chunkX * CHUNK_WIDTH;
             int worldZ = j + chunkZ * CHUNK_LENGTH;
-            emitFace(v, worldX, worldZ, k, texID, w, d);
-        }
+            emitFace(v, worldX, worldZ, k, texIDs[t], w, d);
+        });
+        occupied &= occupied - 1;
     }
 }
 
 /**
- * @param scale The scale used for the perlin generation size.
- * @return A vector of vertices storing the generated chunk.
+ * Greedily merges the faces of a z facing direction one x-y plane at a time.
+ * The column masks already are the rows (one per x, bits along y), so quads
+ * grow along x and then up the wall.
  */
-std::vector<Vertex> PerlinGen::generate(float scale, int chunkX, int chunkZ) {
+static void meshZFacingFaces(
+    std::vector<Vertex>& v,
+    const FaceMasks& faces,
+    const float (&texIDs)[2],
+    int chunkX, int chunkZ,
+    FaceEmitter emitFace
+) {
+    for (int j = 0; j < (int)CHUNK_LENGTH; j++) {
+        ColumnMask rows[2][CHUNK_WIDTH];
+        for (int t = 0; t < 2; t++)
+            for (int i = 0; i < (int)CHUNK_WIDTH; i++)
+                rows[t][i] = faces[t][i][j];
 
-    std::vector<Vertex>v;
+        greedyMergePlane(rows, true, true, [&](int t, int i, int k, int w, int h) {
+            int worldX = i + chunkX * CHUNK_WIDTH;
+            int worldZ = j + chunkZ * CHUNK_LENGTH;
+            emitFace(v, worldX, worldZ, k, texIDs[t], w, h);
+        });
+    }
+}
 
-    // initialize chunk
-    // structure is [x][z][y] to keep y as the vertical axis
-    std::vector<std::vector<std::vector<int>>>chunk( // TODO: change to flat array
-        CHUNK_WIDTH, std::vector<std::vector<int>>(
-            CHUNK_LENGTH, std::vector<int> (CHUNK_HEIGHT, 0)
-        )
-    );
-
-    auto isAir = [&](int x, int z, int y) -> bool {
-        if (x < 0 || x >= CHUNK_WIDTH ||
-            z < 0 || z >= CHUNK_LENGTH ||
-            y < 0 || y >= CHUNK_HEIGHT) {
-            return true;
-        }
-        return chunk[x][z][y] == airID;
+/**
+ * Greedily merges the faces of an x facing direction one z-y plane at a time,
+ * growing quads along z and then up the wall.
+ */
+static void meshXFacingFaces(
+    std::vector<Vertex>& v,
+    const FaceMasks& faces,
+    const float (&texIDs)[2],
+    int chunkX, int chunkZ,
+    FaceEmitter emitFace
+) {
+    for (int i = 0; i < (int)CHUNK_WIDTH; i++) {
+        ColumnMask rows[2][CHUNK_LENGTH];
+        for (int t = 0; t < 2; t++)
+            for (int j = 0; j < (int)CHUNK_LENGTH; j++)
+                rows[t][j] = faces[t][i][j];
+
+        greedyMergePlane(rows, true, true, [&](int t, int j, int k, int d, int h) {
+            int worldX = i + chunkX * CHUNK_WIDTH;
+            int worldZ = j + chunkZ * CHUNK_LENGTH;
+            emitFace(v, worldX, worldZ, k, texIDs[t], d, h);
+        });
+    }
+}
+
+static_assert(CHUNK_WIDTH < 32 && CHUNK_LENGTH < 32 && CHUNK_HEIGHT < 64,
+              "chunk local positions must fit in a PackedVertex");
+
+/**
+ * Packs a world space vertex relative to the chunk origin, see PackedVertex.
+ */
+static PackedVertex packVertex(const Vertex& vertex, int originX, int originZ) {
+    std::uint32_t x = static_cast<std::uint32_t>(vertex.position.x - originX);
+    std::uint32_t y = static_cast<std::uint32_t>(vertex.position.y);
+    std::uint32_t z = static_cast<std::uint32_t>(vertex.position.z - originZ);
+
+    std::uint32_t face;
+    if (vertex.normal.x > 0.5f) face = FACE_POS_X;
+    else if (vertex.normal.x < -0.5f) face = FACE_NEG_X;
+    else if (vertex.normal.y > 0.5f) face = FACE_POS_Y;
+    else if (vertex.normal.y < -0.5f) face = FACE_NEG_Y;
+    else if (vertex.normal.z > 0.5f) face = FACE_POS_Z;
+    else face = FACE_NEG_Z;
+
+    std::uint32_t u = static_cast<std::uint32_t>(vertex.tex.x);
+    std::uint32_t v = static_cast<std::uint32_t>(vertex.tex.y);
+    std::uint32_t layer = static_cast<std::uint32_t>(vertex.texID);
+
+    PackedVertex packed;
+    packed.position = x | (y << 5) | (z << 11) | (face << 16);
+    packed.attributes = u | (v << 6) | (layer << 12);
+    return packed;
+}
+
+/**
+ * @param scale The scale used for the perlin generation size.
+ * @param format Vertex layout of the returned mesh.
+ * @param cancelled Optional flag polled between meshing passes, generation is
+ * abandoned as soon as it is set.
+ * @param profile Optional, filled with the time of every stage. The clock is
+ * only read when it is given.
+ * @return The mesh of the generated chunk, empty if cancelled.
+ */
+ChunkMesh PerlinGen::generate(float scale, int chunkX, int chunkZ,
+                              VertexFormat format,
+                              const std::atomic<bool>* cancelled,
+                              GenerationProfile* profile) {
+    auto isCancelled = [cancelled]() {
+        return cancelled && cancelled->load(std::memory_order_relaxed);
     };
 
-    // random flower texture generator
-    std::mt19937 gen(std::random_device{}());
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point stageStart;
+    if (profile) stageStart = Clock::now();
+    // nanoseconds since the previous stage ended
+    auto lap = [&stageStart]() {
+        Clock::time_point now = Clock::now();
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - stageStart).count();
+        stageStart = now;
+        return ns;
+    };
 
-    for (int i = 0; i < (int)CHUNK_WIDTH; i++) {
-        for (int j = 0; j < (int)CHUNK_LENGTH; j++) {
+    ChunkMesh mesh;
+    mesh.format = format;
+
+    // packed meshes are built as floats in a per thread scratch buffer first
+    thread_local std::vector<Vertex> scratch;
+    std::vector<Vertex>& v = format == VertexFormat::Float ? mesh.vertices : scratch;
+    v.clear();
+
+    // initialize chunk
+    // structure is [x][z][y] to keep y as the vertical axis
+    // the interior and the side border columns are fully overwritten below,
+    // the corner columns and the border above and below are never written
+    // and stay air
+    thread_local ChunkVoxels chunk;
+
+    // the border columns are sampled from the same noise as the neighboring
+    // chunks, so faces against solid blocks across a chunk edge are culled
+    // without needing the neighbor to be loaded
+    for (int i = -1; i <= (int)CHUNK_WIDTH; i++) {
+        for (int j = -1; j <= (int)CHUNK_LENGTH; j++) {
+            if (isCorner(i, j)) continue;
+            BlockID* column = chunk.column(i, j);
             for (int k = 0; k < (int)CHUNK_HEIGHT; k++) {
                 float nX = (i + chunkX * (int)CHUNK_WIDTH)  * scale;
                 float nZ = (j + chunkZ * (int)CHUNK_LENGTH) * scale;
@@ -142,143 +359,140 @@ std::vector<Vertex> PerlinGen::generate(float scale, int chunkX, int chunkZ) {
                 float heightGradient = (static_cast<float>(k) / CHUNK_HEIGHT) * 2.0f - 1.0f;
                 float finalValue = noiseValue - heightGradient;
 
-                chunk[i][j][k] = (finalValue > airThreshold) ? solidID : airID;
+                column[k] = (finalValue > airThreshold) ? solidID : airID;
             }
         }
     }
+    if (profile) {
+        profile->fillNs = lap();
+        profile->voxelsSampled = ((CHUNK_WIDTH + 2) * (CHUNK_LENGTH + 2) - 4) * CHUNK_HEIGHT;
+    }
 
-    /* Greed meshing */
-    // top faces
-    for (int k = 0; k < CHUNK_HEIGHT; k++) {
-        Mask2D mask(CHUNK_WIDTH, std::vector<float>(CHUNK_LENGTH, -1.0f));
-        for (int i = 0; i < CHUNK_WIDTH; i++) {
-            for (int j = 0; j < CHUNK_LENGTH; j++) {
-                if (chunk[i][j][k] != airID && isAir(i, j, k + 1)) {
-                    float r = dist(gen);
-                    // flowers dont merge with grass - different texID keeps them separate // TODO: find way to make this extensible to other textures
-                    mask[i][j] = r < chance ? flowerTex : topTex;
-                }
-            }
+    if (isCancelled()) return {};
+
+    // solid bit masks per column, including the side border columns
+    thread_local ColumnMasks columns = {};
+    for (int i = -1; i <= (int)CHUNK_WIDTH; i++) {
+        for (int j = -1; j <= (int)CHUNK_LENGTH; j++) {
+            if (isCorner(i, j)) continue;
+            const BlockID* column = chunk.column(i, j);
+            ColumnMask bits = 0;
+            for (int k = 0; k < (int)CHUNK_HEIGHT; k++)
+                bits |= static_cast<ColumnMask>(column[k] != airID) << k;
+            columns[i + 1][j + 1] = bits;
         }
-        greedyMergeXZ(v, mask, CHUNK_WIDTH, CHUNK_LENGTH, k, chunkX, chunkZ, addTopFaceGreedy);
     }
-
-    // bottom faces
-    for (int k = 0; k < CHUNK_HEIGHT; k++) {
-        Mask2D mask(CHUNK_WIDTH, std::vector<float>(CHUNK_LENGTH, -1.0f));
-        for (int i = 0; i < CHUNK_WIDTH; i++)
-            for (int j = 0; j < CHUNK_LENGTH; j++)
-                if (chunk[i][j][k] != airID && isAir(i, j, k - 1))
-                    mask[i][j] = defaultTex;
-        greedyMergeXZ(v, mask, CHUNK_WIDTH, CHUNK_LENGTH, k, chunkX, chunkZ, addBottomFaceGreedy);
+    auto solid = [&](int x, int z) -> ColumnMask { return columns[x + 1][z + 1]; };
+
+    // every face lies between the lowest and highest solid block
+    ColumnMask anySolid = 0;
+    for (int i = 0; i < (int)CHUNK_WIDTH; i++)
+        for (int j = 0; j < (int)CHUNK_LENGTH; j++)
+            anySolid |= solid(i, j);
+    if (anySolid) {
+        mesh.minY = countTrailingZeros(anySolid);
+        mesh.maxY = 64 - countLeadingZeros(anySolid);
     }
+    if (profile) profile->maskNs = lap();
 
-    // front faces +z — merge along z only, height = 1
-    for (int k = 0; k < CHUNK_HEIGHT; k++) {
-        Mask2D mask(CHUNK_WIDTH, std::vector<float>(CHUNK_LENGTH, -1.0f));
-        for (int i = 0; i < CHUNK_WIDTH; i++) {
-            for (int j = 0; j < CHUNK_LENGTH; j++) {
-                if (chunk[i][j][k] != airID && isAir(i, j + 1, k)) {
-                    bool topExposed = (k + 1 >= CHUNK_HEIGHT) || chunk[i][j][k + 1] == airID;
-                    mask[i][j] = topExposed ? sideTex : defaultTex;
-                }
-            }
-        }
-        // for side faces only merge width (x), not depth (z is face direction)
-        Used2D used(CHUNK_WIDTH, std::vector<bool>(CHUNK_LENGTH, false));
-        for (int i = 0; i < CHUNK_WIDTH; i++) {
-            for (int j = 0; j < CHUNK_LENGTH; j++) {
-                if (used[i][j] || mask[i][j] < 0.0f) continue;
-                float texID = mask[i][j];
-                int w = 1;
-                while (i + w < CHUNK_WIDTH && !used[i + w][j] && mask[i + w][j] == texID) w++;
-                for (int di = 0; di < w; di++) used[i + di][j] = true;
-                int worldX = i + chunkX * CHUNK_WIDTH;
-                int worldZ = j + chunkZ * CHUNK_LENGTH;
-                addFrontFaceGreedy(v, worldX, worldZ, k, texID, w, 1);
-            }
-        }
-    }
+    /* Greed meshing */
+    thread_local FaceMasks faces;
+
+    // side faces use the grass side texture where the block above is air
+    const float sideTexIDs[2] = {sideTex, defaultTex};
+    auto splitSideFaces = [&](int i, int j, ColumnMask exposed) {
+        ColumnMask covered = solid(i, j) >> 1;
+        faces[0][i][j] = exposed & ~covered;
+        faces[1][i][j] = exposed & covered;
+    };
 
-    // back faces -z
-    for (int k = 0; k < CHUNK_HEIGHT; k++) {
-        Mask2D mask(CHUNK_WIDTH, std::vector<float>(CHUNK_LENGTH, -1.0f));
-        for (int i = 0; i < CHUNK_WIDTH; i++) {
-            for (int j = 0; j < CHUNK_LENGTH; j++) {
-                if (chunk[i][j][k] != airID && isAir(i, j - 1, k)) {
-                    bool topExposed = (k + 1 >= CHUNK_HEIGHT) || chunk[i][j][k + 1] == airID;
-                    mask[i][j] = topExposed ? sideTex : defaultTex;
-                }
-            }
-        }
-        Used2D used(CHUNK_WIDTH, std::vector<bool>(CHUNK_LENGTH, false));
-        for (int i = 0; i < CHUNK_WIDTH; i++) {
-            for (int j = 0; j < CHUNK_LENGTH; j++) {
-                if (used[i][j] || mask[i][j] < 0.0f) continue;
-                float texID = mask[i][j];
-                int w = 1;
-                while (i + w < CHUNK_WIDTH && !used[i + w][j] && mask[i + w][j] == texID) w++;
-                for (int di = 0; di < w; di++) used[i + di][j] = true;
-                int worldX = i + chunkX * CHUNK_WIDTH;
-                int worldZ = j + chunkZ * CHUNK_LENGTH;
-                addBackFaceGreedy(v, worldX, worldZ, k, texID, w, 1);
+    // quads of each direction are stored contiguously, in Face order
+    std::size_t faceStart = 0;
+    auto closeFace = [&](Face face) {
+        std::size_t quads = v.size() / QUAD_VERTICES;
+        mesh.faceFirstQuad[face] = static_cast<std::uint32_t>(faceStart);
+        mesh.faceQuadCount[face] = static_cast<std::uint32_t>(quads - faceStart);
+        faceStart = quads;
+        if (profile) profile->faceNs[face] = lap();
+    };
+
+    // right faces +x — merge along z and y, the grass side texture only ever
+    // covers one block of height since the block above it is air
+    if (isCancelled()) return {};
+    for (int i = 0; i < (int)CHUNK_WIDTH; i++)
+        for (int j = 0; j < (int)CHUNK_LENGTH; j++)
+            splitSideFaces(i, j, solid(i, j) & ~solid(i + 1, j));
+    meshXFacingFaces(v, faces, sideTexIDs, chunkX, chunkZ, addRightFaceGreedy);
+    closeFace(FACE_POS_X);
+
+    // left faces -x - merge along z and y
+    if (isCancelled()) return {};
+    for (int i = 0; i < (int)CHUNK_WIDTH; i++)
+        for (int j = 0; j < (int)CHUNK_LENGTH; j++)
+            splitSideFaces(i, j, solid(i, j) & ~solid(i - 1, j));
+    meshXFacingFaces(v, faces, sideTexIDs, chunkX, chunkZ, addLeftFaceGreedy);
+    closeFace(FACE_NEG_X);
+
+    // top faces
+    if (isCancelled()) return {};
+    // flowers dont merge with grass - different texID keeps them separate // TODO: find way to make this extensible to other textures
+    const float topTexIDs[2] = {topTex, flowerTex};
+    for (int i = 0; i < (int)CHUNK_WIDTH; i++) {
+        for (int j = 0; j < (int)CHUNK_LENGTH; j++) {
+            ColumnMask exposed = solid(i, j) & ~(solid(i, j) >> 1);
+            ColumnMask flowers = 0;
+            for (ColumnMask bits = exposed; bits; bits &= bits - 1) {
+                int k = countTrailingZeros(bits);
+                int worldX = i + chunkX * (int)CHUNK_WIDTH;
+                int worldZ = j + chunkZ * (int)CHUNK_LENGTH;
+                if (blockRandom(worldX, k, worldZ) < chance)
+                    flowers |= ColumnMask(1) << k;
             }
+            faces[0][i][j] = exposed & ~flowers;
+            faces[1][i][j] = flowers;
         }
     }
+    meshHorizontalFaces(v, faces, topTexIDs, chunkX, chunkZ, addTopFaceGreedy);
+    closeFace(FACE_POS_Y);
 
-    // right faces +x — merge along z
-    for (int k = 0; k < CHUNK_HEIGHT; k++) {
-        Mask2D mask(CHUNK_WIDTH, std::vector<float>(CHUNK_LENGTH, -1.0f));
-        for (int i = 0; i < CHUNK_WIDTH; i++) {
-            for (int j = 0; j < CHUNK_LENGTH; j++) {
-                if (chunk[i][j][k] != airID && isAir(i + 1, j, k)) {
-                    bool topExposed = (k + 1 >= CHUNK_HEIGHT) || chunk[i][j][k + 1] == airID;
-                    mask[i][j] = topExposed ? sideTex : defaultTex;
-                }
-            }
-        }
-        Used2D used(CHUNK_WIDTH, std::vector<bool>(CHUNK_LENGTH, false));
-        for (int i = 0; i < CHUNK_WIDTH; i++) {
-            for (int j = 0; j < CHUNK_LENGTH; j++) {
-                if (used[i][j] || mask[i][j] < 0.0f) continue;
-                float texID = mask[i][j];
-                int d = 1;
-                while (j + d < CHUNK_LENGTH && !used[i][j + d] && mask[i][j + d] == texID) d++;
-                for (int dj = 0; dj < d; dj++) used[i][j + dj] = true;
-                int worldX = i + chunkX * CHUNK_WIDTH;
-                int worldZ = j + chunkZ * CHUNK_LENGTH;
-                addRightFaceGreedy(v, worldX, worldZ, k, texID, d, 1);
-            }
+    // bottom faces
+    if (isCancelled()) return {};
+    const float bottomTexIDs[2] = {defaultTex, defaultTex};
+    for (int i = 0; i < (int)CHUNK_WIDTH; i++) {
+        for (int j = 0; j < (int)CHUNK_LENGTH; j++) {
+            faces[0][i][j] = solid(i, j) & ~(solid(i, j) << 1);
+            faces[1][i][j] = 0;
         }
     }
+    meshHorizontalFaces(v, faces, bottomTexIDs, chunkX, chunkZ, addBottomFaceGreedy);
+    closeFace(FACE_NEG_Y);
 
-    // left faces -x - merge along x
-    for (int k = 0; k < CHUNK_HEIGHT; k++) {
-        Mask2D mask(CHUNK_WIDTH, std::vector<float>(CHUNK_LENGTH, -1.0f));
-        for (int i = 0; i < CHUNK_WIDTH; i++) {
-            for (int j = 0; j < CHUNK_LENGTH; j++) {
-                if (chunk[i][j][k] != airID && isAir(i - 1, j, k)) {
-                    bool topExposed = (k + 1 >= CHUNK_HEIGHT) || chunk[i][j][k + 1] == airID;
-                    mask[i][j] = topExposed ? sideTex : defaultTex;
-                }
-            }
-        }
-        Used2D used(CHUNK_WIDTH, std::vector<bool>(CHUNK_LENGTH, false));
-        for (int i = 0; i < CHUNK_WIDTH; i++) {
-            for (int j = 0; j < CHUNK_LENGTH; j++) {
-                if (used[i][j] || mask[i][j] < 0.0f) continue;
-                float texID = mask[i][j];
-                int d = 1;
-                while (j + d < CHUNK_LENGTH && !used[i][j + d] && mask[i][j + d] == texID) d++;
-                for (int dj = 0; dj < d; dj++) used[i][j + dj] = true;
-                int worldX = i + chunkX * CHUNK_WIDTH;
-                int worldZ = j + chunkZ * CHUNK_LENGTH;
-                addLeftFaceGreedy(v, worldX, worldZ, k, texID, d, 1);
-            }
-        }
+    // front faces +z — merge along x and y
+    if (isCancelled()) return {};
+    for (int i = 0; i < (int)CHUNK_WIDTH; i++)
+        for (int j = 0; j < (int)CHUNK_LENGTH; j++)
+            splitSideFaces(i, j, solid(i, j) & ~solid(i, j + 1));
+    meshZFacingFaces(v, faces, sideTexIDs, chunkX, chunkZ, addFrontFaceGreedy);
+    closeFace(FACE_POS_Z);
+
+    // back faces -z
+    if (isCancelled()) return {};
+    for (int i = 0; i < (int)CHUNK_WIDTH; i++)
+        for (int j = 0; j < (int)CHUNK_LENGTH; j++)
+            splitSideFaces(i, j, solid(i, j) & ~solid(i, j - 1));
+    meshZFacingFaces(v, faces, sideTexIDs, chunkX, chunkZ, addBackFaceGreedy);
+    closeFace(FACE_NEG_Z);
+
+    if (format == VertexFormat::Packed) {
+        int originX = chunkX * (int)CHUNK_WIDTH;
+        int originZ = chunkZ * (int)CHUNK_LENGTH;
+        mesh.packedVertices.reserve(v.size());
+        for (const Vertex& vertex : v)
+            mesh.packedVertices.push_back(packVertex(vertex, originX, originZ));
+        if (profile) profile->packNs = lap();
     }
-    
-    return v;
+
+    return mesh;
 };
 
 void PerlinGen::addTopFaceGreedy(std::vector<Vertex>& v, int x, int z, int y, float ID, int width, int depth) {
@@ -286,13 +500,10 @@ void PerlinGen::addTopFaceGreedy(std::vector<Vertex>& v, int x, int z, int y, fl
     float w = static_cast<float>(width);
     float d = static_cast<float>(depth);
 
-    v.push_back({glm::vec3(x, y + 1, z), normal, {0.0f, 0.0f}, ID});
-    v.push_back({glm::vec3(x + w, y + 1, z + d), normal, {w, d}, ID});
-    v.push_back({glm::vec3(x + w, y + 1, z), normal, {w, 0.0f}, ID});
-
     v.push_back({glm::vec3(x, y + 1, z), normal, {0.0f, 0.0f}, ID});
     v.push_back({glm::vec3(x, y + 1, z + d), normal, {0.0f, d}, ID});
     v.push_back({glm::vec3(x + w, y + 1, z + d), normal, {w, d}, ID});
+    v.push_back({glm::vec3(x + w, y + 1, z), normal, {w, 0.0f}, ID});
 }
 
 void PerlinGen::addBottomFaceGreedy(std::vector<Vertex>& v, int x, int z, int y, float ID, int width, int depth) {
@@ -303,9 +514,6 @@ void PerlinGen::addBottomFaceGreedy(std::vector<Vertex>& v, int x, int z, int y,
     v.push_back({glm::vec3(x, y, z), normal, {0.0f, 0.0f}, ID});
     v.push_back({glm::vec3(x, y, z + d), normal, {0.0f, d}, ID});
     v.push_back({glm::vec3(x + w, y, z + d), normal, {w, d}, ID});
-
-    v.push_back({glm::vec3(x, y, z), normal, {0.0f, 0.0f}, ID});
-    v.push_back({glm::vec3(x + w, y, z + d), normal, {w, d}, ID});
     v.push_back({glm::vec3(x + w, y, z), normal, {w, 0.0f}, ID});
 }
 
@@ -315,12 +523,9 @@ void PerlinGen::addFrontFaceGreedy(std::vector<Vertex>& v, int x, int z, int y,
     float h = static_cast<float>(height);
 
     v.push_back({glm::vec3(x, y, z + 1), normal, {0.0f, h}, ID});
-    v.push_back({glm::vec3(x + w, y, z + 1), normal, {w,    h}, ID});
-    v.push_back({glm::vec3(x + w, y + h, z + 1), normal, {w, 0.0f},ID});
-
-    v.push_back({glm::vec3(x, y, z + 1), normal, {0.0f, h},   ID});
-    v.push_back({glm::vec3(x + w, y + h, z + 1), normal, {w, 0.0f},ID});
-    v.push_back({glm::vec3(x, y + h, z + 1), normal, {0.0f, 0.0f},ID});
+    v.push_back({glm::vec3(x + w, y, z + 1), normal, {w, h}, ID});
+    v.push_back({glm::vec3(x + w, y + h, z + 1), normal, {w, 0.0f}, ID});
+    v.push_back({glm::vec3(x, y + h, z + 1), normal, {0.0f, 0.0f}, ID});
 }
 
 void PerlinGen::addBackFaceGreedy(std::vector<Vertex>& v, int x, int z, int y, float ID, int width, int height) {
@@ -329,11 +534,8 @@ void PerlinGen::addBackFaceGreedy(std::vector<Vertex>& v, int x, int z, int y, f
     float h = static_cast<float>(height);
 
     v.push_back({glm::vec3(x, y, z), normal, {0.0f, h}, ID});
-    v.push_back({glm::vec3(x, y + h, z), normal, {0.0f, 0.0f},ID});
-    v.push_back({glm::vec3(x + w, y + h, z), normal, {w, 0.0f},ID});
-
-    v.push_back({glm::vec3(x, y, z), normal, {0.0f, h}, ID});
-    v.push_back({glm::vec3(x + w, y + h, z), normal, {w, 0.0f},ID});
+    v.push_back({glm::vec3(x, y + h, z), normal, {0.0f, 0.0f}, ID});
+    v.push_back({glm::vec3(x + w, y + h, z), normal, {w, 0.0f}, ID});
     v.push_back({glm::vec3(x + w, y, z), normal, {w, h}, ID});
 }
 
@@ -345,9 +547,6 @@ void PerlinGen::addRightFaceGreedy(std::vector<Vertex>& v, int x, int z, int y,
     v.push_back({glm::vec3(x + 1, y, z), normal, {0.0f, h}, ID});
     v.push_back({glm::vec3(x + 1, y + h, z), normal, {0.0f, 0.0f}, ID});
     v.push_back({glm::vec3(x + 1, y + h, z + d), normal, {d, 0.0f}, ID});
-
-    v.push_back({glm::vec3(x + 1, y, z), normal, {0.0f, h}, ID});
-    v.push_back({glm::vec3(x + 1, y + h, z + d), normal, {d, 0.0f}, ID});
     v.push_back({glm::vec3(x + 1, y, z + d), normal, {d, h}, ID});
 }
 
@@ -359,8 +558,5 @@ void PerlinGen::addLeftFaceGreedy(std::vector<Vertex>& v, int x, int z, int y, f
     v.push_back({glm::vec3(x, y, z), normal, {d, h}, ID});
     v.push_back({glm::vec3(x, y, z + d), normal, {0.0f, h}, ID});
     v.push_back({glm::vec3(x, y + h, z + d), normal, {0.0f, 0.0f}, ID});
-
-    v.push_back({glm::vec3(x, y, z), normal, {d, h}, ID});
-    v.push_back({glm::vec3(x, y + h, z + d), normal, {0.0f, 0.0f}, ID});
     v.push_back({glm::vec3(x, y + h, z), normal, {d, 0.0f}, ID});
-}
\ No newline at end of file
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
 
@@ -10,9 +13,126 @@ struct Vertex {
     float texID;
 };
 
+/**
+ * @brief 8 byte vertex decoded in the vertex shaders.
+ *
+ * position:   x (bits 0-4), y (bits 5-10), z (bits 11-15) relative to the
+ *             chunk origin, face index (bits 16-18, see Face)
+ * attributes: texture coordinates, which are the quad extents at the far
+ *             corners (u bits 0-5, v bits 6-11), texture layer (bits 12-19)
+ */
+struct PackedVertex {
+    std::uint32_t position;
+    std::uint32_t attributes;
+};
+
+/**
+ * @brief Face directions, in the order of the normal table in the shaders.
+ */
+enum Face {
+    FACE_POS_X,
+    FACE_NEG_X,
+    FACE_POS_Y,
+    FACE_NEG_Y,
+    FACE_POS_Z,
+    FACE_NEG_Z
+};
+
+constexpr int FACE_COUNT = 6;
+
+enum class VertexFormat {
+    /** Vertex: world space floats, 36 bytes */
+    Float,
+    /** PackedVertex: chunk local integers, 8 bytes */
+    Packed
+};
+
+/**
+ * @brief Vertices per quad in a chunk mesh and indices drawing it. Quads are
+ * stored as 4 counter-clockwise corners and drawn as the triangles (0, 1, 2)
+ * and (0, 2, 3) through a shared index buffer.
+ */
+constexpr int QUAD_VERTICES = 4;
+constexpr int QUAD_INDICES = 6;
+
+/**
+ * @brief Generated mesh of a chunk in one of the two vertex layouts. Only the
+ * vector matching format is filled.
+ */
+struct ChunkMesh {
+    VertexFormat format = VertexFormat::Float;
+    std::vector<Vertex> vertices;
+    std::vector<PackedVertex> packedVertices;
+    /**
+     * @brief Quads are grouped by direction, these give the range of each
+     * direction's quads, indexed by Face.
+     */
+    std::uint32_t faceFirstQuad[FACE_COUNT] = {};
+    std::uint32_t faceQuadCount[FACE_COUNT] = {};
+    /**
+     * @brief Vertical extent of the mesh in blocks, from the bottom of the
+     * lowest solid block to the top of the highest.
+     */
+    int minY = 0;
+    int maxY = 0;
+    /**
+     * @brief Vertex count kept by releaseVertices(), used while the vectors
+     * are empty.
+     */
+    std::size_t releasedVertices = 0;
+
+    std::size_t vertexCount() const {
+        std::size_t stored =
+            format == VertexFormat::Packed ? packedVertices.size() : vertices.size();
+        return stored > 0 ? stored : releasedVertices;
+    }
+    /**
+     * @brief Frees the vertices once a copy lives elsewhere (staging memory,
+     * the GPU). Counts and face ranges stay valid, data() does not.
+     */
+    void releaseVertices() {
+        releasedVertices = vertexCount();
+        std::vector<Vertex>().swap(vertices);
+        std::vector<PackedVertex>().swap(packedVertices);
+    }
+    std::size_t stride() const {
+        return format == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+    }
+    std::size_t byteSize() const { return vertexCount() * stride(); }
+    std::size_t quadCount() const { return vertexCount() / QUAD_VERTICES; }
+    std::size_t indexCount() const { return quadCount() * QUAD_INDICES; }
+    const void* data() const {
+        return format == VertexFormat::Packed ? static_cast<const void*>(packedVertices.data())
+                                              : static_cast<const void*>(vertices.data());
+    }
+};
+
+/**
+ * @brief Time spent in each stage of one PerlinGen::generate() call, in
+ * nanoseconds.
+ */
+struct GenerationProfile {
+    /** Noise sampling into the voxel grid. */
+    long long fillNs = 0;
+    /** Solid bit masks per column. */
+    long long maskNs = 0;
+    /** Face masks and greedy merging of each direction, indexed by Face. */
+    long long faceNs[FACE_COUNT] = {};
+    /** Conversion to packed vertices, 0 for float meshes. */
+    long long packNs = 0;
+    /** Noise samples taken, border columns included. */
+    int voxelsSampled = 0;
+};
+
 class PerlinGen {
     public:
-        static std::vector<Vertex> generate(float scale, int chunkX, int chunkZ);
+        /**
+         * @param profile Optional, receives the time spent per stage.
+         */
+        static ChunkMesh generate(float scale, int chunkX, int chunkZ,
+                                  VertexFormat format = VertexFormat::Float,
+                                  const std::atomic<bool>* cancelled = nullptr,
+                                  GenerationProfile* profile = nullptr);
         static std::vector<Vertex> generateGreedy(float scale, int chunkX, int chunkZ);
 
     private:
@@ -0,0 +1,93 @@
+#include "frustum.hpp"
+
+/*
+Process
+
+Planes are rows of the view-projection matrix added to or subtracted from its
+last row, clip space -w <= x, y, z <= w turned into world space. A box is
+outside once its corner furthest along a plane's normal (the "positive
+vertex") lies behind that plane.
+
+cull() runs plane by plane over the whole box list. Which min/max array feeds
+the positive vertex only depends on the plane, so it is picked once per plane
+and the inner loop is a branchless multiply-add over flat arrays.
+*/
+
+int BoxList::add(const glm::vec3& min, const glm::vec3& max) {
+    minX.push_back(min.x);
+    minY.push_back(min.y);
+    minZ.push_back(min.z);
+    maxX.push_back(max.x);
+    maxY.push_back(max.y);
+    maxZ.push_back(max.z);
+    return static_cast<int>(size()) - 1;
+}
+
+void BoxList::swapRemove(int index) {
+    std::vector<float>* components[] = {&minX, &minY, &minZ, &maxX, &maxY, &maxZ};
+    for (std::vector<float>* component : components) {
+        (*component)[index] = component->back();
+        component->pop_back();
+    }
+}
+
+void BoxList::clear() {
+    minX.clear();
+    minY.clear();
+    minZ.clear();
+    maxX.clear();
+    maxY.clear();
+    maxZ.clear();
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection) {
+    // glm is column major, m[column][row]
+    const glm::mat4& m = viewProjection;
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes[0] = row3 + row0; // left
+    planes[1] = row3 - row0; // right
+    planes[2] = row3 + row1; // bottom
+    planes[3] = row3 - row1; // top
+    planes[4] = row3 + row2; // near
+    planes[5] = row3 - row2; // far
+
+    for (glm::vec4& plane : planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+}
+
+bool Frustum::intersects(const glm::vec3& min, const glm::vec3& max) const {
+    for (const glm::vec4& plane : planes) {
+        glm::vec3 positive(
+            plane.x > 0.0f ? max.x : min.x,
+            plane.y > 0.0f ? max.y : min.y,
+            plane.z > 0.0f ? max.z : min.z
+        );
+        if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Frustum::cull(const BoxList& boxes, std::vector<unsigned char>& visible) const {
+    std::size_t count = boxes.size();
+    visible.assign(count, 1);
+    unsigned char* out = visible.data();
+
+    for (const glm::vec4& plane : planes) {
+        const float* xs = plane.x > 0.0f ? boxes.maxX.data() : boxes.minX.data();
+        const float* ys = plane.y > 0.0f ? boxes.maxY.data() : boxes.minY.data();
+        const float* zs = plane.z > 0.0f ? boxes.maxZ.data() : boxes.minZ.data();
+        float a = plane.x, b = plane.y, c = plane.z, d = plane.w;
+
+        for (std::size_t i = 0; i < count; i++) {
+            float distance = a * xs[i] + b * ys[i] + c * zs[i] + d;
+            out[i] &= static_cast<unsigned char>(distance >= 0.0f);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Axis aligned boxes stored as a structure of arrays, so a culling
+ * pass walks contiguous floats per component and vectorizes.
+ */
+struct BoxList {
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    std::size_t size() const { return minX.size(); }
+
+    /**
+     * @return Index of the new box.
+     */
+    int add(const glm::vec3& min, const glm::vec3& max);
+    /**
+     * @brief Removes a box by moving the last box into its slot.
+     */
+    void swapRemove(int index);
+    void clear();
+};
+
+/**
+ * @class Frustum
+ * @brief Clip volume of a view-projection matrix as six planes facing inwards.
+ *
+ * Works for perspective and orthographic matrices alike, the planes are
+ * extracted from the combined matrix (Gribb-Hartmann).
+ */
+class Frustum {
+    public:
+        Frustum() = default;
+        explicit Frustum(const glm::mat4& viewProjection);
+
+        /**
+         * @return True if the box is at least partly inside. Boxes near a
+         * corner of the frustum may pass without intersecting it.
+         */
+        bool intersects(const glm::vec3& min, const glm::vec3& max) const;
+
+        /**
+         * @brief Tests every box in the list.
+         * @param visible Resized to the box count, 1 for boxes that may be
+         * inside and 0 for boxes fully outside.
+         */
+        void cull(const BoxList& boxes, std::vector<unsigned char>& visible) const;
+
+    private:
+        /** left, right, bottom, top, near, far as (normal, distance) */
+        glm::vec4 planes[6];
+};
@@ -0,0 +1,252 @@
+#include "gl_chunk_backend.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <glad/glad.h>
+
+#include "shader.h"
+
+/*
+Process
+
+1. Workers copy finished meshes into the staging ring's open segment. The
+   render thread advances the ring before its uploads and fences it after.
+
+2. upload() grows the shared quad index buffer to cover the mesh, allocates
+   its range in the arena, fills it from the staging block with a GPU copy
+   (or from CPU memory when the mesh was not staged) and writes the chunk
+   origin into the page's origin table. Arena pages whose free space got too
+   scattered are compacted once the frame's uploads are done.
+
+3. A pass sets the vertex format uniforms. draw() queues index ranges into
+   the batch of the page the mesh lives on, and a batch is submitted with one
+   glMultiDrawElementsBaseVertex call when the next mesh is on another page
+   or the pass ends. ChunkManager sorts its draws by page (batchGroup) so
+   each page is bound once.
+*/
+
+/**
+ * Size of one arena page. A full world at render distance 16 fits in one page
+ * of packed vertices.
+ */
+static constexpr std::size_t ARENA_PAGE_BYTES = 16 * 1024 * 1024;
+
+/**
+ * Share of an arena page's free space allowed to sit outside its largest free
+ * range before the page is compacted.
+ */
+static constexpr float DEFRAGMENT_THRESHOLD = 0.5f;
+
+/**
+ * Texture unit of the arena's chunk origin table, after the block textures (0)
+ * and the shadow map (1).
+ */
+static constexpr int ORIGIN_TEXTURE_UNIT = 2;
+
+/**
+ * Quads the shared index buffer is first created for, well above the few
+ * hundred a typical chunk needs.
+ */
+static constexpr std::size_t INITIAL_QUAD_CAPACITY = 4096;
+
+/**
+ * Staging ring layout. A segment is closed every frame something was written
+ * to it and reused once the GPU finished copying out of it, a few frames
+ * later.
+ */
+static constexpr std::size_t STAGING_SEGMENT_BYTES = 2 * 1024 * 1024;
+static constexpr int STAGING_SEGMENTS = 8;
+
+GlChunkBackend::GlChunkBackend()
+    : arena(ARENA_PAGE_BYTES, ORIGIN_TEXTURE_UNIT),
+      stagingRing(STAGING_SEGMENT_BYTES, STAGING_SEGMENTS) {
+    setVertexFormat(format);
+}
+
+GlChunkBackend::~GlChunkBackend() {
+    if (quadEBO != 0) glDeleteBuffers(1, &quadEBO);
+}
+
+/**
+ * Points the arena at the vertex layout of the format. Only valid while no
+ * mesh is allocated.
+ */
+void GlChunkBackend::setVertexFormat(VertexFormat vertexFormat) {
+    format = vertexFormat;
+    if (format == VertexFormat::Packed) {
+        arena.reset(sizeof(PackedVertex), []() {
+            // Position, face, extents and texture layer in two words
+            glVertexAttribIPointer(4, 2, GL_UNSIGNED_INT, sizeof(PackedVertex), (void*)0);
+            glEnableVertexAttribArray(4);
+        });
+        return;
+    }
+
+    arena.reset(sizeof(Vertex), []() {
+        // Vertex positions
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        // Normals
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                              (void*)offsetof(Vertex, normal));
+        glEnableVertexAttribArray(1);
+
+        // Texture coordinates
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                              (void*)offsetof(Vertex, tex));
+        glEnableVertexAttribArray(2);
+
+        // Texture id
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                              (void*)offsetof(Vertex, texID));
+        glEnableVertexAttribArray(3);
+    });
+}
+
+bool GlChunkBackend::stage(const ChunkMesh& mesh, StagingBlock& block) {
+    std::size_t bytes = mesh.byteSize();
+    if (bytes == 0 || !stagingRing.reserve(bytes, block)) return false;
+
+    std::memcpy(block.data, mesh.data(), bytes);
+    stagingRing.commit(block);
+    return true;
+}
+
+void GlChunkBackend::beginUploads() {
+    stagingRing.advance();
+}
+
+bool GlChunkBackend::isReadable(const StagingBlock& block) const {
+    return stagingRing.isReadable(block);
+}
+
+void GlChunkBackend::dropStaged(const StagingBlock& block) {
+    stagingRing.release(block);
+}
+
+/**
+ * Grows the shared quad index buffer so it covers at least the given number of
+ * quads. The buffer object keeps its name, so the VAO referencing it stays
+ * valid.
+ */
+void GlChunkBackend::reserveQuadIndices(std::size_t quads) {
+    if (quads <= quadIndexCapacity) return;
+
+    std::size_t capacity = std::max(quadIndexCapacity * 2, INITIAL_QUAD_CAPACITY);
+    while (capacity < quads) capacity *= 2;
+
+    std::vector<GLuint> indices;
+    indices.reserve(capacity * QUAD_INDICES);
+    for (std::size_t quad = 0; quad < capacity; ++quad) {
+        GLuint first = static_cast<GLuint>(quad * QUAD_VERTICES);
+        indices.push_back(first);
+        indices.push_back(first + 1);
+        indices.push_back(first + 2);
+        indices.push_back(first);
+        indices.push_back(first + 2);
+        indices.push_back(first + 3);
+    }
+
+    if (quadEBO == 0) {
+        glGenBuffers(1, &quadEBO);
+        arena.setElementBuffer(quadEBO);
+    }
+
+    // upload through the copy target so no VAO's element binding is touched
+    glBindBuffer(GL_COPY_WRITE_BUFFER, quadEBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(GLuint), indices.data(),
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    quadIndexCapacity = capacity;
+}
+
+int GlChunkBackend::upload(const ChunkMesh& mesh, const StagingBlock& staging,
+                           const glm::ivec3& origin) {
+    reserveQuadIndices(mesh.quadCount());
+
+    int handle = arena.allocate(static_cast<std::uint32_t>(mesh.vertexCount()));
+    if (staging.segment != -1) {
+        arena.copyFrom(handle, stagingRing.bufferOf(staging), staging.offset);
+        stagingRing.release(staging);
+    } else {
+        arena.upload(handle, mesh.data());
+    }
+    arena.setOrigin(handle, origin.x, origin.y, origin.z);
+    return handle;
+}
+
+void GlChunkBackend::release(int handle) {
+    arena.release(handle);
+}
+
+void GlChunkBackend::endUploads() {
+    stagingRing.fence();
+    arena.defragment(DEFRAGMENT_THRESHOLD);
+}
+
+/**
+ * Sets up the vertex format uniforms shared by every chunk draw.
+ */
+void GlChunkBackend::beginPass(const Shader& shader) {
+    shader.setBool("packedVertices", format == VertexFormat::Packed);
+    shader.setInt("chunkOrigins", ORIGIN_TEXTURE_UNIT);
+    shader.setInt("originBlockVertices", static_cast<int>(MeshArena::BLOCK_VERTICES));
+    boundPage = -1;
+    pass = SubmitStats();
+}
+
+int GlChunkBackend::batchGroup(int handle) const {
+    return arena.get(handle).page;
+}
+
+int GlChunkBackend::batchGroupCount() const {
+    return arena.pageCount();
+}
+
+/**
+ * Queues a range into the multi-draw batch of the mesh's arena page, first
+ * submitting the batch of the page bound before.
+ */
+void GlChunkBackend::draw(int handle, std::size_t firstQuad, std::size_t quads) {
+    const ArenaAllocation& allocation = arena.get(handle);
+    if (allocation.page != boundPage) {
+        flushBatch();
+        arena.bindPage(allocation.page);
+        boundPage = allocation.page;
+    }
+
+    batchCounts.push_back(static_cast<int>(quads * QUAD_INDICES));
+    batchOffsets.push_back((void*)(firstQuad * QUAD_INDICES * sizeof(GLuint)));
+    batchBaseVertices.push_back(static_cast<int>(allocation.first));
+}
+
+/**
+ * Submits the ranges queued for the bound page in one call.
+ */
+void GlChunkBackend::flushBatch() {
+    if (batchCounts.empty()) return;
+
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, batchCounts.data(), GL_UNSIGNED_INT,
+                                  batchOffsets.data(), static_cast<GLsizei>(batchCounts.size()),
+                                  batchBaseVertices.data());
+    pass.drawCalls++;
+    pass.drawRanges += static_cast<int>(batchCounts.size());
+
+    batchCounts.clear();
+    batchOffsets.clear();
+    batchBaseVertices.clear();
+}
+
+SubmitStats GlChunkBackend::endPass() {
+    flushBatch();
+    return pass;
+}
+
+BackendStats GlChunkBackend::getStats() const {
+    BackendStats stats;
+    stats.arena = arena.getStats();
+    stats.staging = stagingRing.getStats();
+    stats.indexBytes = quadIndexCapacity * QUAD_INDICES * sizeof(GLuint);
+    return stats;
+}
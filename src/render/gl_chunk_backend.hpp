@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include "../world/chunk_backend.hpp"
+#include "mesh_arena.hpp"
+#include "staging_ring.hpp"
+
+/**
+ * @class GlChunkBackend
+ * @brief OpenGL ChunkBackend. Meshes are sub-allocated from a MeshArena,
+ * workers stage them in a StagingRing and draws are submitted with one
+ * glMultiDrawElementsBaseVertex call per arena page.
+ *
+ * GL objects are created on first use, so the backend can be constructed
+ * before the context exists. They are deleted with the backend, which must
+ * then happen while the context is still current (ChunkManager::shutdown()).
+ */
+class GlChunkBackend : public ChunkBackend {
+    public:
+        GlChunkBackend();
+        ~GlChunkBackend() override;
+
+        void setVertexFormat(VertexFormat format) override;
+
+        bool stage(const ChunkMesh& mesh, StagingBlock& block) override;
+        void beginUploads() override;
+        bool isReadable(const StagingBlock& block) const override;
+        void dropStaged(const StagingBlock& block) override;
+        int upload(const ChunkMesh& mesh, const StagingBlock& staging,
+                   const glm::ivec3& origin) override;
+        void release(int handle) override;
+        void endUploads() override;
+
+        void beginPass(const Shader& shader) override;
+        int batchGroup(int handle) const override;
+        int batchGroupCount() const override;
+        void draw(int handle, std::size_t firstQuad, std::size_t quads) override;
+        SubmitStats endPass() override;
+
+        BackendStats getStats() const override;
+
+    private:
+        VertexFormat format = VertexFormat::Packed;
+
+        /**
+         * @brief Element buffer with the indices of quadIndexCapacity quads,
+         * bound to the arena's VAO. Quads use the same index pattern offset by
+         * 4 vertices, so one buffer serves every mesh.
+         */
+        unsigned int quadEBO = 0;
+        std::size_t quadIndexCapacity = 0;
+
+        /**
+         * @brief Vertex buffer pages every chunk mesh is sub-allocated from.
+         */
+        MeshArena arena;
+        /**
+         * @brief Mapped buffers workers write finished meshes into, so
+         * uploads are GPU side copies into the arena.
+         */
+        StagingRing stagingRing;
+        /* Arena page the VAO points at during a pass */
+        int boundPage = -1;
+
+        /* glMultiDrawElementsBaseVertex arguments collected for boundPage */
+        std::vector<int> batchCounts;
+        std::vector<const void*> batchOffsets;
+        std::vector<int> batchBaseVertices;
+        SubmitStats pass;
+
+        void reserveQuadIndices(std::size_t quads);
+        void flushBatch();
+};
@@ -0,0 +1,117 @@
+#include "gpu_profiler.hpp"
+
+#include <glad/glad.h>
+
+GpuProfiler::GpuProfiler(int framesInFlight) : frames(framesInFlight) {}
+
+GpuProfiler::~GpuProfiler() {
+    for (Frame& frame : frames) {
+        if (!frame.queries.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        }
+    }
+}
+
+void GpuProfiler::beginFrame() {
+#if VOXEL_PROFILING
+    // oldest first, starting at the frame that is reused next
+    for (int i = 0; i < static_cast<int>(frames.size()); i++) {
+        Frame& frame = frames[(next + i) % frames.size()];
+        if (frame.pending) collect(frame);
+    }
+
+    current = -1;
+    depth = 0;
+    Frame& frame = frames[next];
+    if (frame.pending) return; // results not available yet, skip this frame
+
+    frame.usedQueries = 0;
+    frame.zones.clear();
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    frame.cpuStartNs = Profiler::now();
+    frame.gpuStartNs = gpuNow;
+    current = next;
+    next = (next + 1) % static_cast<int>(frames.size());
+#endif
+}
+
+void GpuProfiler::endFrame() {
+    if (current == -1) return;
+    Frame& frame = frames[current];
+    frame.pending = !frame.zones.empty();
+    current = -1;
+}
+
+unsigned int GpuProfiler::nextQuery(Frame& frame) {
+    if (frame.usedQueries == frame.queries.size()) {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        frame.queries.push_back(query);
+    }
+    return frame.queries[frame.usedQueries++];
+}
+
+void GpuProfiler::beginZone(const char* name) {
+    if (current == -1) return;
+    Frame& frame = frames[current];
+    Zone zone;
+    zone.name = name;
+    zone.beginQuery = nextQuery(frame);
+    zone.endQuery = 0;
+    zone.depth = depth++;
+    glQueryCounter(zone.beginQuery, GL_TIMESTAMP);
+    frame.zones.push_back(zone);
+}
+
+void GpuProfiler::endZone() {
+    if (current == -1) return;
+    Frame& frame = frames[current];
+    depth--;
+    // innermost zone still open
+    for (auto it = frame.zones.rbegin(); it != frame.zones.rend(); ++it) {
+        if (it->endQuery == 0) {
+            it->endQuery = nextQuery(frame);
+            glQueryCounter(it->endQuery, GL_TIMESTAMP);
+            return;
+        }
+    }
+}
+
+/**
+ * Reads the timestamps of a frame once the last one is available.
+ * @return False if the GPU is not done with the frame yet.
+ */
+bool GpuProfiler::collect(Frame& frame) {
+    // timestamps complete in order, the last query issued is the last to finish
+    GLuint last = frame.queries[frame.usedQueries - 1];
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(last, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) return false;
+
+    if (track == -1) track = Profiler::get().addTrack("GPU");
+
+    std::vector<GLuint64> begins(frame.zones.size());
+    std::vector<GLuint64> ends(frame.zones.size());
+    for (std::size_t i = 0; i < frame.zones.size(); i++) {
+        glGetQueryObjectui64v(frame.zones[i].beginQuery, GL_QUERY_RESULT, &begins[i]);
+        if (frame.zones[i].endQuery != 0) {
+            glGetQueryObjectui64v(frame.zones[i].endQuery, GL_QUERY_RESULT, &ends[i]);
+        }
+    }
+    // without a readable GPU clock the frame starts at its first zone
+    long long gpuStart = frame.gpuStartNs != 0 ? frame.gpuStartNs : static_cast<long long>(begins[0]);
+
+    for (std::size_t i = 0; i < frame.zones.size(); i++) {
+        const Zone& zone = frame.zones[i];
+        if (zone.endQuery == 0) continue; // never closed, nothing to report
+        ProfileEvent event;
+        event.name = zone.name;
+        event.startNs = frame.cpuStartNs + static_cast<long long>(begins[i]) - gpuStart;
+        event.endNs = frame.cpuStartNs + static_cast<long long>(ends[i]) - gpuStart;
+        event.depth = zone.depth;
+        Profiler::get().recordOn(track, event);
+    }
+    frame.pending = false;
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include "../utils/profiler.hpp"
+
+#if VOXEL_PROFILING
+#define GPU_PROFILE_ZONE(profiler, name) GpuZone PROFILE_CONCAT(gpuZone, __LINE__)(profiler, name)
+#else
+#define GPU_PROFILE_ZONE(profiler, name) ((void)0)
+#endif
+
+/**
+ * @class GpuProfiler
+ * @brief Times nested spans of GL commands with GL_TIMESTAMP queries and
+ * feeds them into the Profiler as a "GPU" track.
+ *
+ * Each frame has its own set of queries, kept in a ring of framesInFlight
+ * frames. Results are read at the next beginFrame() once the GPU made them
+ * available; a frame whose slot is still busy when the ring wraps around is
+ * not timed instead of waited for.
+ *
+ * Zones are placed on the CPU timeline by reading the GPU clock when the frame
+ * begins, so they show when the GPU actually ran the commands, behind the CPU
+ * zones that issued them.
+ *
+ * Every method must run on the thread owning the GL context.
+ */
+class GpuProfiler {
+    public:
+        explicit GpuProfiler(int framesInFlight = 4);
+        ~GpuProfiler();
+
+        /**
+         * @brief Collects finished frames and starts timing a new one.
+         */
+        void beginFrame();
+        void endFrame();
+
+        void beginZone(const char* name);
+        void endZone();
+
+    private:
+        struct Zone {
+            const char* name;
+            unsigned int beginQuery;
+            unsigned int endQuery;
+            int depth;
+        };
+
+        struct Frame {
+            std::vector<unsigned int> queries;
+            std::size_t usedQueries = 0;
+            std::vector<Zone> zones;
+            /* Profiler::now() and GL_TIMESTAMP read together at beginFrame() */
+            long long cpuStartNs = 0;
+            long long gpuStartNs = 0;
+            bool pending = false;
+        };
+
+        unsigned int nextQuery(Frame& frame);
+        bool collect(Frame& frame);
+
+        std::vector<Frame> frames;
+        int next = 0;
+        /* Frame being recorded, -1 if this one is skipped */
+        int current = -1;
+        int depth = 0;
+        int track = -1;
+};
+
+/**
+ * @class GpuZone
+ * @brief Scoped GpuProfiler zone, use through GPU_PROFILE_ZONE.
+ */
+class GpuZone {
+    public:
+        GpuZone(GpuProfiler& profiler, const char* name) : profiler(profiler) {
+            profiler.beginZone(name);
+        }
+        ~GpuZone() { profiler.endZone(); }
+
+        GpuZone(const GpuZone&) = delete;
+        GpuZone& operator=(const GpuZone&) = delete;
+
+    private:
+        GpuProfiler& profiler;
+};
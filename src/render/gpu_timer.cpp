@@ -0,0 +1,47 @@
+#include "gpu_timer.hpp"
+
+#include <glad/glad.h>
+
+GpuTimer::GpuTimer(int ringSize) : slots(ringSize) {}
+
+GpuTimer::~GpuTimer() {
+    for (Slot& slot : slots) {
+        if (slot.query != 0) glDeleteQueries(1, &slot.query);
+    }
+}
+
+void GpuTimer::begin(long long frame) {
+    Slot& slot = slots[next];
+    if (slot.pending) return; // result not collected yet, skip this frame
+
+    if (slot.query == 0) glGenQueries(1, &slot.query);
+    glBeginQuery(GL_TIME_ELAPSED, slot.query);
+    slot.frame = frame;
+    active = next;
+    next = (next + 1) % static_cast<int>(slots.size());
+}
+
+void GpuTimer::end() {
+    if (active == -1) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    slots[active].pending = true;
+    active = -1;
+}
+
+void GpuTimer::collect(const ResultFn& onResult, bool wait) {
+    // oldest first, starting at the slot begin() reuses next
+    for (int i = 0; i < static_cast<int>(slots.size()); i++) {
+        Slot& slot = slots[(next + i) % slots.size()];
+        if (!slot.pending) continue;
+
+        if (!wait) {
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(slot.query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == GL_FALSE) continue;
+        }
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(slot.query, GL_QUERY_RESULT, &nanoseconds);
+        slot.pending = false;
+        onResult(slot.frame, nanoseconds * 1e-6);
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+/**
+ * @class GpuTimer
+ * @brief Measures the GPU time of a span of commands per frame with
+ * GL_TIME_ELAPSED queries, without stalling on results.
+ *
+ * Queries are kept in a ring. A result is collected once the GPU made it
+ * available, usually a frame or two after its end(). Frames whose query slot
+ * is still busy when the ring wraps around are skipped instead of waited for.
+ *
+ * Every method must run on the thread owning the GL context, queries are
+ * created on first use.
+ */
+class GpuTimer {
+    public:
+        /**
+         * @brief Receives the frame passed to begin() and the measured time.
+         */
+        using ResultFn = std::function<void(long long frame, double milliseconds)>;
+
+        explicit GpuTimer(int ringSize = 4);
+        ~GpuTimer();
+
+        void begin(long long frame);
+        void end();
+
+        /**
+         * @brief Reports every finished query whose result is available.
+         * @param wait Block until every finished query has a result, e.g.
+         * before writing final numbers.
+         */
+        void collect(const ResultFn& onResult, bool wait = false);
+
+    private:
+        struct Slot {
+            unsigned int query = 0;
+            long long frame = -1;
+            bool pending = false;
+        };
+
+        std::vector<Slot> slots;
+        int next = 0;
+        /* Slot between begin() and end(), -1 outside */
+        int active = -1;
+};
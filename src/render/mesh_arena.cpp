@@ -0,0 +1,207 @@
+#include "mesh_arena.hpp"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+/*
+Process
+
+1. allocate() asks the RangeAllocator (range_allocator.cpp) for the smallest
+   free range of any page that fits, carved off its front and recorded under
+   a new handle. When the allocator had to add a page, its buffer and origin
+   table are created here.
+
+2. release() returns the range to the allocator, which merges it with the free
+   ranges right before and after it so a free list never holds two touching
+   ranges.
+
+3. Drawing binds the single VAO, repoints the attributes at a page's buffer and
+   binds the page's origin table. Meshes are drawn with their first vertex as
+   base vertex. Allocations are rounded up to whole blocks, so a block never
+   holds two meshes and one origin per block is enough.
+
+4. defragment() has the allocator pick the page whose free space is most
+   scattered and, past the threshold, compact it: live allocations move back
+   to back, leaving one free range at the end. Each move is copied with
+   glCopyBufferSubData into a fresh buffer. Handles and the origin table are
+   updated in place.
+*/
+
+static constexpr std::size_t ORIGIN_COMPONENTS = 4;
+
+MeshArena::MeshArena(std::size_t pageBytes, int originTextureUnit)
+    : pageBytes(pageBytes), originTextureUnit(originTextureUnit) {}
+
+MeshArena::~MeshArena() {
+    deletePages();
+    if (VAO != 0) glDeleteVertexArrays(1, &VAO);
+}
+
+void MeshArena::deletePages() {
+    for (Page& page : pages) {
+        glDeleteBuffers(1, &page.buffer);
+        glDeleteBuffers(1, &page.originBuffer);
+        glDeleteTextures(1, &page.originTexture);
+    }
+    pages.clear();
+}
+
+void MeshArena::reset(std::size_t stride, LayoutFn layout) {
+    deletePages();
+    // attributes the old layout enabled would stay enabled and keep pointing
+    // at deleted pages, bindPage() builds a fresh VAO for the new layout
+    if (VAO != 0) {
+        glDeleteVertexArrays(1, &VAO);
+        VAO = 0;
+    }
+    ranges.reset(static_cast<std::uint32_t>(pageBytes / stride));
+    this->stride = stride;
+    this->layout = std::move(layout);
+}
+
+void MeshArena::addPage(std::uint32_t capacity) {
+    Page page;
+    page.origins.assign(capacity / BLOCK_VERTICES * ORIGIN_COMPONENTS, 0);
+
+    glGenBuffers(1, &page.buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, page.buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity * stride, nullptr, GL_DYNAMIC_DRAW);
+
+    glGenBuffers(1, &page.originBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, page.originBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, page.origins.size() * sizeof(std::int32_t),
+                 page.origins.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glGenTextures(1, &page.originTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, page.originTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32I, page.originBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    pages.push_back(std::move(page));
+}
+
+int MeshArena::allocate(std::uint32_t vertices) {
+    int handle = ranges.allocate(vertices);
+    // nothing fit, the allocator added a page
+    while (pageCount() < ranges.pageCount()) {
+        addPage(ranges.pageCapacity(pageCount()));
+    }
+    return handle;
+}
+
+void MeshArena::upload(int handle, const void* data) {
+    const ArenaAllocation& allocation = ranges.get(handle);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pages[allocation.page].buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, allocation.first * stride,
+                    allocation.count * stride, data);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void MeshArena::copyFrom(int handle, unsigned int buffer, std::size_t offset) {
+    const ArenaAllocation& allocation = ranges.get(handle);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pages[allocation.page].buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset,
+                        allocation.first * stride, allocation.count * stride);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void MeshArena::setOrigin(int handle, std::int32_t x, std::int32_t y, std::int32_t z) {
+    const ArenaAllocation& allocation = ranges.get(handle);
+    Page& page = pages[allocation.page];
+    std::uint32_t firstBlock = allocation.first / BLOCK_VERTICES;
+    std::uint32_t blocks = RangeAllocator::roundToBlocks(allocation.count) / BLOCK_VERTICES;
+    for (std::uint32_t block = firstBlock; block < firstBlock + blocks; block++) {
+        std::int32_t* entry = &page.origins[block * ORIGIN_COMPONENTS];
+        entry[0] = x;
+        entry[1] = y;
+        entry[2] = z;
+    }
+    uploadOrigins(page, firstBlock, blocks);
+}
+
+void MeshArena::uploadOrigins(const Page& page, std::uint32_t firstBlock, std::uint32_t blocks) {
+    std::size_t entryBytes = ORIGIN_COMPONENTS * sizeof(std::int32_t);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, page.originBuffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, firstBlock * entryBytes, blocks * entryBytes,
+                    &page.origins[firstBlock * ORIGIN_COMPONENTS]);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void MeshArena::release(int handle) {
+    ranges.release(handle);
+}
+
+void MeshArena::setElementBuffer(unsigned int buffer) {
+    elementBuffer = buffer;
+    if (VAO != 0) {
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+    }
+}
+
+void MeshArena::bindPage(int page) {
+    if (VAO == 0) {
+        glGenVertexArrays(1, &VAO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+    }
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, pages[page].buffer);
+    layout();
+
+    glActiveTexture(GL_TEXTURE0 + originTextureUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, pages[page].originTexture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+bool MeshArena::defragment(float threshold) {
+    int worstPage = ranges.mostFragmentedPage(threshold);
+    if (worstPage == -1) return false;
+
+    Page& page = pages[worstPage];
+    std::uint32_t capacity = ranges.pageCapacity(worstPage);
+    unsigned int compacted;
+    glGenBuffers(1, &compacted);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, compacted);
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity * stride, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, page.buffer);
+
+    std::uint32_t end = ranges.compact(
+        worstPage, [&](int, std::uint32_t from, std::uint32_t to, std::uint32_t count) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                from * stride, to * stride, count * stride);
+            // ranges only move towards the start, so entries are never overwritten before being read
+            std::uint32_t reserved = RangeAllocator::roundToBlocks(count);
+            std::copy(page.origins.begin() + from / BLOCK_VERTICES * ORIGIN_COMPONENTS,
+                      page.origins.begin() + (from + reserved) / BLOCK_VERTICES * ORIGIN_COMPONENTS,
+                      page.origins.begin() + to / BLOCK_VERTICES * ORIGIN_COMPONENTS);
+        });
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glDeleteBuffers(1, &page.buffer);
+    page.buffer = compacted;
+    uploadOrigins(page, 0, end / BLOCK_VERTICES);
+    defragmentations++;
+    return true;
+}
+
+ArenaStats MeshArena::getStats() const {
+    ArenaStats stats;
+    stats.pages = pageCount();
+    stats.allocations = ranges.allocationCount();
+    stats.defragmentations = defragmentations;
+    for (int p = 0; p < pageCount(); p++) {
+        std::uint32_t capacity = ranges.pageCapacity(p);
+        std::uint32_t used = ranges.pageUsed(p);
+        std::uint32_t freeVertices = capacity - used;
+        stats.capacityBytes += capacity * stride;
+        stats.usedBytes += used * stride;
+        stats.freeBytes += freeVertices * stride;
+        stats.fragmentedBytes += (freeVertices - ranges.largestFreeRange(p)) * stride;
+    }
+    return stats;
+}
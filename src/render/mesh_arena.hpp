@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "range_allocator.hpp"
+
+/**
+ * @class MeshArena
+ * @brief Sub-allocates meshes of one vertex layout from a few large vertex
+ * buffers (pages) drawn through a single VAO.
+ *
+ * Ranges are handed out by a RangeAllocator (best fit over per page free
+ * lists, merged on release). Meshes are addressed by handle, so
+ * defragmenting a page can move them without their owners noticing.
+ *
+ * Every page has an origin table, a texture buffer of one RGBA32I entry per
+ * block of vertices holding the origin of the mesh in that block. Vertex
+ * shaders fetch it with gl_VertexID / BLOCK_VERTICES (base vertex included),
+ * so meshes with different origins share a single multi-draw call.
+ *
+ * GL objects are created on first use, so an arena can be constructed before
+ * the context exists.
+ */
+class MeshArena {
+    public:
+        /**
+         * @brief Sets the vertex attribute pointers for the buffer bound to
+         * GL_ARRAY_BUFFER, with vertex 0 at offset 0.
+         */
+        using LayoutFn = std::function<void()>;
+
+        /** Vertices per origin table entry */
+        static constexpr std::uint32_t BLOCK_VERTICES = RangeAllocator::BLOCK_VERTICES;
+
+        /**
+         * @param originTextureUnit Texture unit bindPage() binds the origin
+         * table to.
+         */
+        MeshArena(std::size_t pageBytes, int originTextureUnit);
+        /** Deletes the pages and the VAO, the context must still be current. */
+        ~MeshArena();
+
+        /**
+         * @brief Drops every page, allocation and the VAO and switches the
+         * vertex layout used for new pages.
+         */
+        void reset(std::size_t stride, LayoutFn layout);
+
+        /**
+         * @return Handle of a range of the given number of vertices.
+         */
+        int allocate(std::uint32_t vertices);
+        void upload(int handle, const void* data);
+        /**
+         * @brief Fills an allocation from another buffer, on the GPU.
+         */
+        void copyFrom(int handle, unsigned int buffer, std::size_t offset);
+        void release(int handle);
+        /**
+         * @brief Sets the origin the vertex shader reads for every vertex of an
+         * allocation.
+         */
+        void setOrigin(int handle, std::int32_t x, std::int32_t y, std::int32_t z);
+        const ArenaAllocation& get(int handle) const { return ranges.get(handle); }
+
+        /**
+         * @brief Element buffer bound to the arena's VAO.
+         */
+        void setElementBuffer(unsigned int buffer);
+
+        int pageCount() const { return static_cast<int>(pages.size()); }
+        /**
+         * @brief Binds the VAO with its attributes pointing into a page, and
+         * the page's origin table.
+         */
+        void bindPage(int page);
+
+        /**
+         * @brief Compacts the most fragmented page if its fragmented share of
+         * free space exceeds threshold.
+         * @return True if a page was compacted.
+         */
+        bool defragment(float threshold);
+
+        ArenaStats getStats() const;
+
+    private:
+        /** GL objects of a RangeAllocator page */
+        struct Page {
+            unsigned int buffer = 0;
+            unsigned int originBuffer = 0;
+            unsigned int originTexture = 0;
+            /** CPU copy of the origin table, 4 ints per block */
+            std::vector<std::int32_t> origins;
+        };
+
+        std::size_t pageBytes;
+        int originTextureUnit;
+        std::size_t stride = 1;
+        LayoutFn layout;
+
+        unsigned int VAO = 0;
+        unsigned int elementBuffer = 0;
+
+        RangeAllocator ranges;
+        /** Indexed like the allocator's pages */
+        std::vector<Page> pages;
+        int defragmentations = 0;
+
+        void addPage(std::uint32_t capacity);
+        void deletePages();
+        void uploadOrigins(const Page& page, std::uint32_t firstBlock,
+                           std::uint32_t blocks);
+};
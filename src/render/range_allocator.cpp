@@ -0,0 +1,123 @@
+#include "range_allocator.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+/**
+ * Pages with less free space than this share of their capacity are not worth
+ * compacting.
+ */
+static constexpr float MIN_DEFRAGMENT_FREE_SHARE = 0.125f;
+
+RangeAllocator::RangeAllocator(std::uint32_t pageVertices) {
+    reset(pageVertices);
+}
+
+void RangeAllocator::reset(std::uint32_t pageVertices) {
+    this->pageVertices = pageVertices / BLOCK_VERTICES * BLOCK_VERTICES;
+    pages.clear();
+    allocations.clear();
+    freeHandles.clear();
+}
+
+int RangeAllocator::allocate(std::uint32_t vertices) {
+    std::uint32_t reserved = roundToBlocks(vertices);
+    int bestPage = -1;
+    std::uint32_t bestFirst = 0;
+    std::uint32_t bestCount = 0;
+    for (int p = 0; p < pageCount(); p++) {
+        for (const auto& [first, count] : pages[p].freeRanges) {
+            if (count >= reserved && (bestPage == -1 || count < bestCount)) {
+                bestPage = p;
+                bestFirst = first;
+                bestCount = count;
+            }
+        }
+    }
+
+    if (bestPage == -1) {
+        Page added;
+        added.capacity = std::max(pageVertices, reserved);
+        added.freeRanges[0] = added.capacity;
+        pages.push_back(std::move(added));
+        bestPage = pageCount() - 1;
+        bestFirst = 0;
+        bestCount = pages[bestPage].capacity;
+    }
+
+    Page& page = pages[bestPage];
+    page.freeRanges.erase(bestFirst);
+    if (bestCount > reserved) {
+        page.freeRanges[bestFirst + reserved] = bestCount - reserved;
+    }
+    page.used += reserved;
+
+    int handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    } else {
+        handle = static_cast<int>(allocations.size());
+        allocations.emplace_back();
+    }
+    allocations[handle] = {bestPage, bestFirst, vertices};
+    page.live[bestFirst] = handle;
+    return handle;
+}
+
+void RangeAllocator::release(int handle) {
+    ArenaAllocation& allocation = allocations[handle];
+    Page& page = pages[allocation.page];
+    page.live.erase(allocation.first);
+
+    std::uint32_t first = allocation.first;
+    std::uint32_t count = roundToBlocks(allocation.count);
+    page.used -= count;
+
+    // merge with the following range
+    auto next = page.freeRanges.find(first + count);
+    if (next != page.freeRanges.end()) {
+        count += next->second;
+        page.freeRanges.erase(next);
+    }
+
+    // merge with the preceding range
+    auto it = page.freeRanges.lower_bound(first);
+    if (it != page.freeRanges.begin()) {
+        auto previous = std::prev(it);
+        if (previous->first + previous->second == first) {
+            first = previous->first;
+            count += previous->second;
+            page.freeRanges.erase(previous);
+        }
+    }
+    page.freeRanges[first] = count;
+
+    allocation = ArenaAllocation();
+    freeHandles.push_back(handle);
+}
+
+std::uint32_t RangeAllocator::largestFreeRange(int page) const {
+    std::uint32_t largest = 0;
+    for (const auto& [first, count] : pages[page].freeRanges) {
+        largest = std::max(largest, count);
+    }
+    return largest;
+}
+
+int RangeAllocator::mostFragmentedPage(float threshold) const {
+    int worstPage = -1;
+    float worstShare = threshold;
+    for (int p = 0; p < pageCount(); p++) {
+        const Page& page = pages[p];
+        std::uint32_t freeVertices = page.capacity - page.used;
+        if (freeVertices < page.capacity * MIN_DEFRAGMENT_FREE_SHARE) continue;
+
+        float scattered = 1.0f - static_cast<float>(largestFreeRange(p)) / freeVertices;
+        if (scattered > worstShare) {
+            worstPage = p;
+            worstShare = scattered;
+        }
+    }
+    return worstPage;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Location of one mesh inside the arena, in vertices. The range
+ * reserved for it is rounded up to whole blocks of
+ * RangeAllocator::BLOCK_VERTICES.
+ */
+struct ArenaAllocation {
+    int page = -1;
+    std::uint32_t first = 0;
+    std::uint32_t count = 0;
+};
+
+/**
+ * @brief Snapshot of arena usage.
+ */
+struct ArenaStats {
+    int pages = 0;
+    int allocations = 0;
+    std::size_t capacityBytes = 0;
+    std::size_t usedBytes = 0;
+    std::size_t freeBytes = 0;
+    /** Free bytes outside the largest free block of their page. */
+    std::size_t fragmentedBytes = 0;
+    int defragmentations = 0;
+};
+
+/**
+ * @class RangeAllocator
+ * @brief Bookkeeping of MeshArena without any GL: pages of vertices, their
+ * free ranges and the handles of the allocations carved from them.
+ *
+ * Each page keeps a free list of vertex ranges ordered by offset, allocations
+ * take the best fitting range across all pages and freed ranges merge with
+ * their neighbors. Ranges are whole blocks of BLOCK_VERTICES. Allocations are
+ * addressed by handle, so compacting a page can move them without their
+ * owners noticing.
+ */
+class RangeAllocator {
+    public:
+        /** Vertices per block, the allocation granularity */
+        static constexpr std::uint32_t BLOCK_VERTICES = 64;
+
+        /**
+         * @param pageVertices Capacity of new pages, rounded down to whole
+         * blocks. Larger allocations get a page of their own size.
+         */
+        explicit RangeAllocator(std::uint32_t pageVertices = 0);
+
+        /**
+         * @brief Drops every page and allocation, new pages get the given
+         * capacity.
+         */
+        void reset(std::uint32_t pageVertices);
+
+        /**
+         * @return Handle of a range of the given number of vertices. Adds a
+         * page when no free range fits, see pageCount().
+         */
+        int allocate(std::uint32_t vertices);
+        void release(int handle);
+        const ArenaAllocation& get(int handle) const { return allocations[handle]; }
+
+        int pageCount() const { return static_cast<int>(pages.size()); }
+        std::uint32_t pageCapacity(int page) const { return pages[page].capacity; }
+        std::uint32_t pageUsed(int page) const { return pages[page].used; }
+        std::uint32_t largestFreeRange(int page) const;
+        int allocationCount() const {
+            return static_cast<int>(allocations.size() - freeHandles.size());
+        }
+
+        /**
+         * @return The page with the most scattered free space, measured as
+         * the share of it outside the largest free range, if that share
+         * exceeds threshold. -1 otherwise. Pages with little free space are
+         * never picked.
+         */
+        int mostFragmentedPage(float threshold) const;
+
+        /**
+         * @brief Moves the live allocations of a page back to back from its
+         * start, in offset order, leaving one free range at the end.
+         * @param move Called as move(handle, from, to, vertices) for every
+         * live allocation before its range is updated. Ranges only move
+         * towards the start.
+         * @return First vertex after the last allocation.
+         */
+        template <typename MoveFn>
+        std::uint32_t compact(int page, MoveFn move);
+
+        static std::uint32_t roundToBlocks(std::uint32_t vertices) {
+            return (vertices + BLOCK_VERTICES - 1) / BLOCK_VERTICES * BLOCK_VERTICES;
+        }
+
+    private:
+        struct Page {
+            std::uint32_t capacity = 0;
+            std::uint32_t used = 0;
+            /** Free ranges, first vertex -> vertex count */
+            std::map<std::uint32_t, std::uint32_t> freeRanges;
+            /** Live allocations, first vertex -> handle */
+            std::map<std::uint32_t, int> live;
+        };
+
+        std::uint32_t pageVertices;
+        std::vector<Page> pages;
+        std::vector<ArenaAllocation> allocations;
+        std::vector<int> freeHandles;
+};
+
+template <typename MoveFn>
+std::uint32_t RangeAllocator::compact(int pageIndex, MoveFn move) {
+    Page& page = pages[pageIndex];
+    std::map<std::uint32_t, int> live;
+    std::uint32_t cursor = 0;
+    for (const auto& [first, handle] : page.live) {
+        ArenaAllocation& allocation = allocations[handle];
+        move(handle, first, cursor, allocation.count);
+        allocation.first = cursor;
+        live[cursor] = handle;
+        cursor += roundToBlocks(allocation.count);
+    }
+
+    page.live = std::move(live);
+    page.freeRanges.clear();
+    if (cursor < page.capacity) {
+        page.freeRanges[cursor] = page.capacity - cursor;
+    }
+    return cursor;
+}
@@ -0,0 +1,178 @@
+#include "staging_ring.hpp"
+
+#include <iostream>
+#include <glad/glad.h>
+
+/*
+Process
+
+1. advance() runs at the start of the render thread's upload step:
+   - In flight segments whose fence signaled become free.
+   - The open segment is closed if anything was reserved from it, so meshes
+     written this frame can be copied this frame.
+   - Closing segments without writers are unmapped and ready for copying.
+   - If no segment is open, a free one is mapped (created on first use) and
+     opened for workers.
+
+2. Workers reserve a block from the open segment under the mutex, write the
+   mesh to the mapped memory outside of it and commit. A mesh that does not
+   fit is rejected and stays in CPU memory.
+
+3. The render thread copies every readable block into its destination and
+   releases it, or releases it unused when its chunk is gone.
+
+4. fence() puts a fence behind the copies of every unmapped segment with no
+   outstanding blocks. The segment is only written again after that fence
+   signals, so mapping it unsynchronized never races the GPU.
+*/
+
+/** Keeps block offsets aligned for the workers' copies */
+static constexpr std::size_t BLOCK_ALIGNMENT = 16;
+
+StagingRing::StagingRing(std::size_t segmentBytes, int segmentCount)
+    : segmentBytes(segmentBytes), segments(segmentCount) {}
+
+StagingRing::~StagingRing() {
+    for (Segment& segment : segments) {
+        if (segment.sync != nullptr) glDeleteSync(static_cast<GLsync>(segment.sync));
+        // deleting a mapped buffer unmaps it
+        if (segment.buffer != 0) glDeleteBuffers(1, &segment.buffer);
+    }
+}
+
+void StagingRing::advance() {
+    for (Segment& segment : segments) {
+        if (segment.state != State::InFlight) continue;
+
+        GLsync sync = static_cast<GLsync>(segment.sync);
+        GLenum status = glClientWaitSync(sync, 0, 0);
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+            glDeleteSync(sync);
+            std::lock_guard<std::mutex> lock(mutex);
+            segment.sync = nullptr;
+            segment.used = 0;
+            segment.state = State::Free;
+        }
+    }
+
+    std::vector<int> toUnmap;
+    int toMap = -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool hasOpen = false;
+        for (int i = 0; i < static_cast<int>(segments.size()); i++) {
+            Segment& segment = segments[i];
+            if (segment.state == State::Open && segment.used > 0) {
+                segment.state = State::Closing;
+            }
+            if (segment.state == State::Closing && segment.writers == 0) {
+                toUnmap.push_back(i);
+            }
+            if (segment.state == State::Open) hasOpen = true;
+            if (segment.state == State::Free && toMap == -1) toMap = i;
+        }
+        if (hasOpen) toMap = -1;
+    }
+
+    // closing segments without writers are only touched by this thread
+    for (int i : toUnmap) {
+        Segment& segment = segments[i];
+        glBindBuffer(GL_COPY_WRITE_BUFFER, segment.buffer);
+        if (glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_FALSE) {
+            std::cerr << "[Staging] Segment contents lost while mapped\n";
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        segment.mapped = nullptr;
+        segment.state = State::Copying;
+    }
+
+    if (toMap != -1) {
+        Segment& segment = segments[toMap];
+        if (segment.buffer == 0) {
+            glGenBuffers(1, &segment.buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, segment.buffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, segmentBytes, nullptr, GL_STREAM_COPY);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, segment.buffer);
+        void* mapped = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, segmentBytes,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT |
+                                            GL_MAP_UNSYNCHRONIZED_BIT);
+        if (mapped != nullptr) {
+            std::lock_guard<std::mutex> lock(mutex);
+            segment.mapped = static_cast<char*>(mapped);
+            segment.used = 0;
+            segment.state = State::Open;
+        }
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+bool StagingRing::reserve(std::size_t bytes, StagingBlock& block) {
+    std::size_t aligned = (bytes + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int i = 0; i < static_cast<int>(segments.size()); i++) {
+        Segment& segment = segments[i];
+        if (segment.state != State::Open) continue;
+        if (segment.used + aligned > segmentBytes) break;
+
+        block.segment = i;
+        block.offset = segment.used;
+        block.size = bytes;
+        block.data = segment.mapped + segment.used;
+        segment.used += aligned;
+        segment.writers++;
+        segment.outstanding++;
+        blocksStaged++;
+        return true;
+    }
+    blocksRejected++;
+    return false;
+}
+
+void StagingRing::commit(const StagingBlock& block) {
+    std::lock_guard<std::mutex> lock(mutex);
+    segments[block.segment].writers--;
+}
+
+bool StagingRing::isReadable(const StagingBlock& block) const {
+    // only the render thread moves segments out of the closing state
+    return segments[block.segment].state == State::Copying;
+}
+
+unsigned int StagingRing::bufferOf(const StagingBlock& block) const {
+    return segments[block.segment].buffer;
+}
+
+void StagingRing::release(const StagingBlock& block) {
+    std::lock_guard<std::mutex> lock(mutex);
+    segments[block.segment].outstanding--;
+}
+
+void StagingRing::fence() {
+    for (Segment& segment : segments) {
+        if (segment.state != State::Copying) continue;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (segment.outstanding > 0) continue;
+        }
+        segment.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        std::lock_guard<std::mutex> lock(mutex);
+        segment.state = State::InFlight;
+    }
+}
+
+StagingStats StagingRing::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    StagingStats stats;
+    stats.segments = static_cast<int>(segments.size());
+    stats.blocksStaged = blocksStaged;
+    stats.blocksRejected = blocksRejected;
+    for (const Segment& segment : segments) {
+        if (segment.buffer != 0) stats.capacityBytes += segmentBytes;
+        if (segment.state == State::Open || segment.state == State::Closing) stats.mapped++;
+        if (segment.state == State::Copying) stats.copying++;
+        if (segment.state == State::InFlight) stats.inFlight++;
+    }
+    return stats;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Region of a staging segment reserved for one mesh.
+ */
+struct StagingBlock {
+    int segment = -1;
+    std::size_t offset = 0;
+    std::size_t size = 0;
+    /** Mapped memory to write the mesh to, only valid until commit(). */
+    void* data = nullptr;
+};
+
+/**
+ * @brief Snapshot of staging ring usage.
+ */
+struct StagingStats {
+    int segments = 0;
+    /** Buffer memory of the segments created so far. */
+    std::size_t capacityBytes = 0;
+    /** Segments mapped for writing */
+    int mapped = 0;
+    /** Segments waiting for their blocks to be copied */
+    int copying = 0;
+    /** Segments whose copies the GPU may still be running */
+    int inFlight = 0;
+    long long blocksStaged = 0;
+    /** Meshes that found no room and were uploaded from CPU memory instead. */
+    long long blocksRejected = 0;
+};
+
+/**
+ * @class StagingRing
+ * @brief Ring of staging buffers worker threads write finished meshes into,
+ * so the render thread only issues GPU side copies.
+ *
+ * A segment cycles through four states:
+ * - open: mapped, workers reserve blocks from it and write to them.
+ * - closing: mapped, no new reservations, waits for the last writer.
+ * - copying: unmapped, its blocks are copied into their destination buffers.
+ * - in flight: every block is released, a fence tracks the GPU copies.
+ * Once the fence signals the segment is free and gets mapped again, with
+ * GL_MAP_UNSYNCHRONIZED_BIT since the GPU is known to be done with it.
+ *
+ * reserve() and commit() may be called from any thread. Every other method
+ * must run on the thread owning the GL context.
+ */
+class StagingRing {
+    public:
+        StagingRing(std::size_t segmentBytes, int segmentCount);
+        /**
+         * @brief Deletes the segments, mapped or not, and their fences. No
+         * worker may be writing and the context must still be current.
+         */
+        ~StagingRing();
+
+        /**
+         * @brief Frees segments whose copies completed, closes the open
+         * segment if anything was written to it, unmaps closed segments
+         * without writers and maps a free segment for the next reservations.
+         * Call once per frame before copying.
+         */
+        void advance();
+
+        /**
+         * @brief Reserves room for a mesh in the open segment.
+         * @return False if no segment is open or it has no room left, the
+         * caller keeps the mesh in CPU memory then.
+         */
+        bool reserve(std::size_t bytes, StagingBlock& block);
+        /**
+         * @brief Marks a reserved block as written.
+         */
+        void commit(const StagingBlock& block);
+
+        /**
+         * @return True once a block's segment is unmapped and can be copied from.
+         */
+        bool isReadable(const StagingBlock& block) const;
+        unsigned int bufferOf(const StagingBlock& block) const;
+        /**
+         * @brief Marks a block as consumed, after its copy was issued or when
+         * it is dropped, e.g. for a chunk unloaded before its upload.
+         */
+        void release(const StagingBlock& block);
+
+        /**
+         * @brief Fences every unmapped segment whose blocks are all released.
+         * Call after the frame's copies.
+         */
+        void fence();
+
+        StagingStats getStats() const;
+
+    private:
+        enum class State { Free, Open, Closing, Copying, InFlight };
+
+        struct Segment {
+            unsigned int buffer = 0;
+            State state = State::Free;
+            char* mapped = nullptr;
+            std::size_t used = 0;
+            /** Blocks reserved but not committed yet */
+            int writers = 0;
+            /** Blocks reserved but not released yet */
+            int outstanding = 0;
+            /** GLsync of the copies out of this segment */
+            void* sync = nullptr;
+        };
+
+        std::size_t segmentBytes;
+        std::vector<Segment> segments;
+        /** Guards segment state, used, writers and outstanding */
+        mutable std::mutex mutex;
+        long long blocksStaged = 0;
+        long long blocksRejected = 0;
+};
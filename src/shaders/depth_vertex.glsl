@@ -1,9 +1,22 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+layout (location = 4) in uvec2 aPacked; // see PackedVertex
 
 uniform mat4 lightSpaceMatrix;
 uniform mat4 terrainModel;
+uniform bool packedVertices;
+uniform isamplerBuffer chunkOrigins;
+uniform int originBlockVertices;
 
 void main() {
-    gl_Position = lightSpaceMatrix * terrainModel * vec4(aPos, 1.0);
+    vec3 position = aPos;
+    if (packedVertices) {
+        vec3 chunkOrigin = vec3(texelFetch(chunkOrigins, gl_VertexID / originBlockVertices).xyz);
+        position = chunkOrigin + vec3(
+            float(aPacked.x & 31u),
+            float((aPacked.x >> 5u) & 63u),
+            float((aPacked.x >> 11u) & 31u)
+        );
+    }
+    gl_Position = lightSpaceMatrix * terrainModel * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@ layout (location = 0) in vec3 aPos; // position
 layout (location = 1) in vec3 aNormal; // normal
 layout (location = 2) in vec2 aTexCoord; // texture
 layout (location = 3) in float aTexID;
+layout (location = 4) in uvec2 aPacked; // see PackedVertex, used when packedVertices is set
 
 uniform mat4 terrainModel;
 uniform mat4 view;
@@ -14,6 +15,10 @@ uniform vec3 betaRayleigh; // (6.95e-6, 1.18e-5, 2.44e-5)
 uniform vec3 betaMie; // haze scattering coefficient
 uniform float g; // Henyey Greenstein factor
 uniform float Esun; // sun intensity
+uniform bool packedVertices;
+// world position of each block of originBlockVertices vertices, packed positions are relative to it
+uniform isamplerBuffer chunkOrigins;
+uniform int originBlockVertices;
 
 out vec3 outTexCoord;
 out vec3 outFragPos;
@@ -24,6 +29,16 @@ out vec4 outFragPosLightSpace;
 
 const float pi = 3.14159;
 
+// indexed by the face bits of a packed vertex, same order as Face
+const vec3 faceNormals[6] = vec3[6](
+    vec3(1.0, 0.0, 0.0),
+    vec3(-1.0, 0.0, 0.0),
+    vec3(0.0, 1.0, 0.0),
+    vec3(0.0, -1.0, 0.0),
+    vec3(0.0, 0.0, 1.0),
+    vec3(0.0, 0.0, -1.0)
+);
+
 // atmospheric scattering
 vec3 computeFex(float s) {
     vec3 betaEx = betaRayleigh + betaMie;
@@ -43,10 +58,27 @@ float miePhase(float cosTheta) {
 
 void main()
 {
-    vec4 worldPos = terrainModel * vec4(aPos, 1.0);
+    vec3 position = aPos;
+    vec3 normal = aNormal;
+    vec2 texCoord = aTexCoord;
+    float texID = aTexID;
+
+    if (packedVertices) {
+        vec3 chunkOrigin = vec3(texelFetch(chunkOrigins, gl_VertexID / originBlockVertices).xyz);
+        position = chunkOrigin + vec3(
+            float(aPacked.x & 31u),
+            float((aPacked.x >> 5u) & 63u),
+            float((aPacked.x >> 11u) & 31u)
+        );
+        normal = faceNormals[(aPacked.x >> 16u) & 7u];
+        texCoord = vec2(float(aPacked.y & 63u), float((aPacked.y >> 6u) & 63u));
+        texID = float((aPacked.y >> 12u) & 255u);
+    }
+
+    vec4 worldPos = terrainModel * vec4(position, 1.0);
     outFragPos = worldPos.xyz;
-    outNormal = mat3(transpose(inverse(terrainModel))) * aNormal;
-    outTexCoord = vec3(aTexCoord.x, aTexCoord.y, aTexID);
+    outNormal = mat3(transpose(inverse(terrainModel))) * normal;
+    outTexCoord = vec3(texCoord.x, texCoord.y, texID);
     gl_Position = projection * view * worldPos;
 
     outFragPosLightSpace = lightSpaceMatrix * vec4(outFragPos, 1.0);
@@ -0,0 +1,336 @@
+/**
+ * Microbenchmarks of the generation, meshing and streaming hot paths. Results
+ * are written as JSON so runs can be compared to catch regressions.
+ *
+ * Usage: voxel_bench [--quick] [--only NAME] [--out FILE]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stb_perlin.h>
+#include <glm/glm.hpp>
+
+#include "../noise/perlin_gen.hpp"
+#include "../world/chunk_gen.hpp"
+#include "../world/null_backend.hpp"
+#include "streaming.hpp"
+
+/*
+Process
+
+1. noise3: raw stb_perlin_noise3 samples over a lattice at the terrain scale.
+
+2. generate_packed / generate_float: PerlinGen::generate over a grid of
+   distinct chunks, with a GenerationProfile per call to split the time into
+   voxel fill, column masks, face masking plus greedy merging per direction
+   and packing. A few chunks are generated first so the per thread scratch
+   buffers are warm.
+
+3. generate_world: the fixed world of the VoxelGrid measurement, every chunk
+   from -10 to 9 on both axes (400 chunks) at the terrain scale in the packed
+   format, on the calling thread only. The pass is repeated and the fastest,
+   median and slowest pass are reported, so runs before and after a change
+   compare on the same chunks:
+
+       voxel_bench --only generate_world --out grid.json
+
+4. update_rN: a ChunkManager on a NullBackend at render distance N. The cost
+   of update() itself is measured for the initial load, for chunk crossings
+   and for frames without a crossing; the world is settled (every chunk
+   generated and uploaded) after each step and that time is reported too.
+
+Allocations are counted by replacing the global operator new, every thread
+included, so streaming figures count the workers' allocations as well.
+*/
+
+static std::atomic<long long> allocationCount{0};
+static std::atomic<long long> allocatedBytes{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    if (void* memory = std::malloc(size > 0 ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** Noise scale ChunkManager generates terrain with */
+constexpr float TERRAIN_SCALE = 0.05f;
+
+/** Voxels inside one chunk, 16 x 16 x 32 */
+constexpr int CHUNK_VOXELS = 16 * 16 * 32;
+
+const char* FACE_NAMES[FACE_COUNT] = {"pos_x", "neg_x", "pos_y", "neg_y", "pos_z", "neg_z"};
+
+struct Result {
+    std::string name = {};
+    std::vector<std::pair<std::string, double>> metrics = {};
+
+    void add(const std::string& metric, double value) { metrics.emplace_back(metric, value); }
+};
+
+struct AllocationMark {
+    long long count = allocationCount.load();
+    long long bytes = allocatedBytes.load();
+
+    long long countSince() const { return allocationCount.load() - count; }
+    long long bytesSince() const { return allocatedBytes.load() - bytes; }
+};
+
+double nanosecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+Result benchNoise(int samples) {
+    // a lattice the size of a 32 x 32 chunk area, walked like the voxel fill
+    volatile float sink = 0.0f;
+    int taken = 0;
+    Clock::time_point start = Clock::now();
+    while (taken < samples) {
+        for (int x = 0; x < 512 && taken < samples; x++) {
+            for (int z = 0; z < 512 && taken < samples; z++) {
+                for (int y = 0; y < 32; y++) {
+                    sink = sink + stb_perlin_noise3(x * TERRAIN_SCALE, y * TERRAIN_SCALE,
+                                                    z * TERRAIN_SCALE, 0, 0, 0);
+                }
+                taken += 32;
+            }
+        }
+    }
+    double ns = nanosecondsSince(start);
+
+    Result result{"noise3"};
+    result.add("samples", taken);
+    result.add("ns_per_sample", ns / taken);
+    return result;
+}
+
+Result benchGenerate(VertexFormat format, int chunks) {
+    for (int i = 0; i < 8; i++) PerlinGen::generate(TERRAIN_SCALE, -1 - i, -1, format);
+
+    GenerationProfile total;
+    GenerationProfile profile;
+    long long vertices = 0;
+    AllocationMark allocations;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < chunks; i++) {
+        ChunkMesh mesh = PerlinGen::generate(TERRAIN_SCALE, i % 32, i / 32, format, nullptr,
+                                             &profile);
+        vertices += static_cast<long long>(mesh.vertexCount());
+        total.fillNs += profile.fillNs;
+        total.maskNs += profile.maskNs;
+        for (int face = 0; face < FACE_COUNT; face++) total.faceNs[face] += profile.faceNs[face];
+        total.packNs += profile.packNs;
+        total.voxelsSampled += profile.voxelsSampled;
+    }
+    double ns = nanosecondsSince(start);
+    long long allocationsMade = allocations.countSince();
+    long long bytesAllocated = allocations.bytesSince();
+
+    long long facesNs = 0;
+    for (int face = 0; face < FACE_COUNT; face++) facesNs += total.faceNs[face];
+    long long quads = vertices / QUAD_VERTICES;
+
+    Result result{format == VertexFormat::Packed ? "generate_packed" : "generate_float"};
+    result.add("chunks", chunks);
+    result.add("chunks_per_s", chunks / (ns * 1e-9));
+    result.add("ns_per_chunk", ns / chunks);
+    result.add("ns_per_voxel", ns / chunks / CHUNK_VOXELS);
+    result.add("fill_ns_per_voxel", static_cast<double>(total.fillNs) / total.voxelsSampled);
+    result.add("mask_ns_per_chunk", static_cast<double>(total.maskNs) / chunks);
+    for (int face = 0; face < FACE_COUNT; face++) {
+        result.add(std::string("merge_") + FACE_NAMES[face] + "_ns_per_chunk",
+                   static_cast<double>(total.faceNs[face]) / chunks);
+    }
+    result.add("merge_ns_per_quad", quads > 0 ? static_cast<double>(facesNs) / quads : 0.0);
+    result.add("pack_ns_per_chunk", static_cast<double>(total.packNs) / chunks);
+    result.add("vertices_per_chunk", static_cast<double>(vertices) / chunks);
+    result.add("allocations_per_chunk", static_cast<double>(allocationsMade) / chunks);
+    result.add("allocated_bytes_per_chunk", static_cast<double>(bytesAllocated) / chunks);
+    return result;
+}
+
+Result benchWorld(int passes) {
+    constexpr int WORLD_MIN = -10;
+    constexpr int WORLD_MAX = 9;
+    constexpr int WORLD_CHUNKS = (WORLD_MAX - WORLD_MIN + 1) * (WORLD_MAX - WORLD_MIN + 1);
+    // warms the per thread scratch buffers on chunks outside the world
+    for (int i = 0; i < 8; i++) PerlinGen::generate(TERRAIN_SCALE, WORLD_MIN - 1 - i, WORLD_MIN - 1);
+
+    std::vector<double> passNs;
+    long long vertices = 0;
+    AllocationMark allocations;
+    for (int pass = 0; pass < passes; pass++) {
+        vertices = 0;
+        Clock::time_point start = Clock::now();
+        for (int x = WORLD_MIN; x <= WORLD_MAX; x++) {
+            for (int z = WORLD_MIN; z <= WORLD_MAX; z++) {
+                ChunkMesh mesh = PerlinGen::generate(TERRAIN_SCALE, x, z, VertexFormat::Packed);
+                vertices += static_cast<long long>(mesh.vertexCount());
+            }
+        }
+        passNs.push_back(nanosecondsSince(start));
+    }
+    long long allocationsMade = allocations.countSince();
+    std::sort(passNs.begin(), passNs.end());
+    double chunkUs = 1e-3 / WORLD_CHUNKS;
+
+    Result result{"generate_world"};
+    result.add("chunks", WORLD_CHUNKS);
+    result.add("passes", passes);
+    result.add("us_per_chunk_min", passNs.front() * chunkUs);
+    result.add("us_per_chunk_median", passNs[passNs.size() / 2] * chunkUs);
+    result.add("us_per_chunk_max", passNs.back() * chunkUs);
+    result.add("vertices_per_chunk", static_cast<double>(vertices) / WORLD_CHUNKS);
+    result.add("allocations_per_chunk",
+               static_cast<double>(allocationsMade) / (WORLD_CHUNKS * passes));
+    return result;
+}
+
+Result benchUpdate(int radius, int crossings, int idleUpdates) {
+    ChunkManager chunkManager(std::make_unique<NullBackend>());
+    glm::vec3 viewDir(1.0f, 0.0f, 0.0f);
+    std::size_t uploadedBytes = 0;
+    AllocationMark allocations;
+
+    Clock::time_point start = Clock::now();
+    chunkManager.update(0, 0, radius, viewDir);
+    double initialUpdateNs = nanosecondsSince(start);
+    settle(chunkManager, uploadedBytes);
+    double loadNs = nanosecondsSince(start);
+    int loadedChunks = chunkManager.getGenerationCounters().completed;
+
+    double crossingUpdateNs = 0.0;
+    double crossingSettleNs = 0.0;
+    for (int i = 1; i <= crossings; i++) {
+        Clock::time_point crossingStart = Clock::now();
+        chunkManager.update(i, 0, radius, viewDir);
+        crossingUpdateNs += nanosecondsSince(crossingStart);
+        settle(chunkManager, uploadedBytes);
+        crossingSettleNs += nanosecondsSince(crossingStart);
+    }
+
+    Clock::time_point idleStart = Clock::now();
+    for (int i = 0; i < idleUpdates; i++) chunkManager.update(crossings, 0, radius, viewDir);
+    double idleNs = nanosecondsSince(idleStart);
+
+    GenerationCounters jobs = chunkManager.getGenerationCounters();
+    long long allocationsMade = allocations.countSince();
+
+    Result result{"update_r" + std::to_string(radius)};
+    result.add("render_distance", radius);
+    result.add("initial_update_us", initialUpdateNs * 1e-3);
+    result.add("initial_load_ms", loadNs * 1e-6);
+    result.add("initial_chunks", loadedChunks);
+    result.add("initial_chunks_per_s", loadedChunks / (loadNs * 1e-9));
+    result.add("crossings", crossings);
+    result.add("crossing_update_us", crossings > 0 ? crossingUpdateNs * 1e-3 / crossings : 0.0);
+    result.add("crossing_settle_ms", crossings > 0 ? crossingSettleNs * 1e-6 / crossings : 0.0);
+    result.add("idle_update_ns", idleNs / idleUpdates);
+    result.add("chunks_generated", jobs.completed);
+    result.add("vertices_per_chunk", jobs.completed > 0
+        ? static_cast<double>(uploadedBytes) / sizeof(PackedVertex) / jobs.completed : 0.0);
+    result.add("allocations_per_chunk", jobs.completed > 0
+        ? static_cast<double>(allocationsMade) / jobs.completed : 0.0);
+    return result;
+}
+
+std::string toJson(const std::vector<Result>& results, bool quick, int workers) {
+    std::ostringstream out;
+    out.precision(6);
+    out << "{\n";
+    out << "  \"benchmark\": \"voxel_bench\",\n";
+    out << "  \"quick\": " << (quick ? "true" : "false") << ",\n";
+    out << "  \"workers\": " << workers << ",\n";
+    out << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        out << "    {\"name\": \"" << results[i].name << "\"";
+        for (const auto& metric : results[i].metrics) {
+            out << ", \"" << metric.first << "\": " << metric.second;
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+    return out.str();
+}
+
+}
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    std::string only;
+    std::string outPath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            quick = true;
+        } else if (arg == "--only" && i + 1 < argc) {
+            only = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            std::cerr << "usage: voxel_bench [--quick] [--only NAME] [--out FILE]\n";
+            return 1;
+        }
+    }
+    auto wanted = [&only](const std::string& name) { return only.empty() || only == name; };
+
+    std::vector<Result> results;
+    if (wanted("noise3")) results.push_back(benchNoise(quick ? 1 << 18 : 1 << 21));
+    if (wanted("generate_packed")) {
+        results.push_back(benchGenerate(VertexFormat::Packed, quick ? 64 : 512));
+    }
+    if (wanted("generate_float")) {
+        results.push_back(benchGenerate(VertexFormat::Float, quick ? 64 : 512));
+    }
+    if (wanted("generate_world")) results.push_back(benchWorld(quick ? 1 : 5));
+
+    std::vector<int> radii = quick ? std::vector<int>{4, 8} : std::vector<int>{4, 8, 12, 16};
+    for (int radius : radii) {
+        if (wanted("update_r" + std::to_string(radius))) {
+            results.push_back(benchUpdate(radius, quick ? 4 : 16, 100000));
+        }
+    }
+    if (results.empty()) {
+        std::cerr << "[Bench] No benchmark named " << only << '\n';
+        return 1;
+    }
+
+    int workers = ChunkManager(std::make_unique<NullBackend>()).getWorkerCount();
+    std::string json = toJson(results, quick, workers);
+    if (outPath.empty()) {
+        std::cout << json;
+        return 0;
+    }
+
+    std::ofstream file(outPath);
+    if (!file) {
+        std::cerr << "[Bench] Could not write " << outPath << '\n';
+        return 1;
+    }
+    file << json;
+    return 0;
+}
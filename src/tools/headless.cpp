@@ -0,0 +1,194 @@
+/**
+ * Streams chunks along a scripted path without a window or GL context and
+ * reports generation throughput. Runs on servers and in CI.
+ *
+ * Usage: voxel_headless [--radius N] [--steps N] [--stride N] [--path line|circle]
+ *                       [--workers N] [--float] [--compressed] [--latency FILE]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../world/chunk_gen.hpp"
+#include "../world/null_backend.hpp"
+#include "streaming.hpp"
+
+/*
+Process
+
+1. The path is a list of player chunks: a straight line along +x, or a circle
+   around the origin, `stride` chunks apart.
+
+2. For each waypoint the manager is updated with the player there, looking
+   along the path, and frames are pumped until every requested chunk was
+   generated and uploaded to the null backend. Waiting for the world to
+   settle makes each step measure the full cost of a chunk crossing.
+
+3. Totals, per-step timings and the per stage chunk latencies are printed
+   once the path is done. Nothing is drawn, so the stages ending at the first
+   draw stay empty.
+*/
+
+namespace {
+
+constexpr float PI = 3.14159265f;
+
+struct Options {
+    int radius = 8;
+    int steps = 32;
+    int stride = 1;
+    std::string path = "line";
+    int workers = 0;
+    VertexFormat format = VertexFormat::Packed;
+    bool compressed = false;
+    /** Pipeline latency report written here, if set */
+    std::string latencyPath;
+};
+
+void printUsage() {
+    std::cerr << "usage: voxel_headless [--radius N] [--steps N] [--stride N]"
+                 " [--path line|circle] [--workers N] [--float] [--compressed]"
+                 " [--latency FILE]\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--radius" && hasValue) {
+            options.radius = std::atoi(argv[++i]);
+        } else if (arg == "--steps" && hasValue) {
+            options.steps = std::atoi(argv[++i]);
+        } else if (arg == "--stride" && hasValue) {
+            options.stride = std::atoi(argv[++i]);
+        } else if (arg == "--path" && hasValue) {
+            options.path = argv[++i];
+        } else if (arg == "--workers" && hasValue) {
+            options.workers = std::atoi(argv[++i]);
+        } else if (arg == "--float") {
+            options.format = VertexFormat::Float;
+        } else if (arg == "--compressed") {
+            options.compressed = true;
+        } else if (arg == "--latency" && hasValue) {
+            options.latencyPath = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return options.radius >= 0 && options.steps > 0 && options.stride > 0 &&
+           (options.path == "line" || options.path == "circle");
+}
+
+std::vector<glm::ivec2> buildPath(const Options& options) {
+    std::vector<glm::ivec2> waypoints;
+    float circleRadius = options.steps * options.stride / (2.0f * PI);
+    for (int i = 0; i < options.steps; i++) {
+        if (options.path == "line") {
+            waypoints.push_back(glm::ivec2(i * options.stride, 0));
+        } else {
+            float angle = 2.0f * PI * i / options.steps;
+            waypoints.push_back(glm::ivec2(std::lround(circleRadius * std::cos(angle)),
+                                           std::lround(circleRadius * std::sin(angle))));
+        }
+    }
+    return waypoints;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    ChunkManager chunkManager(std::make_unique<NullBackend>());
+    if (options.workers > 0) chunkManager.setWorkerCount(options.workers);
+    chunkManager.setVertexFormat(options.format);
+    chunkManager.setCompressedCopies(options.compressed);
+
+    std::vector<glm::ivec2> waypoints = buildPath(options);
+    std::size_t uploadedBytes = 0;
+    int frames = 0;
+    float slowestStepMs = 0.0f;
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point firstStepEnd;
+    for (std::size_t i = 0; i < waypoints.size(); i++) {
+        glm::ivec2 next = waypoints[(i + 1) % waypoints.size()];
+        glm::vec2 heading = glm::vec2(next - waypoints[i]);
+        glm::vec3 viewDir = glm::length(heading) > 0.0f
+            ? glm::normalize(glm::vec3(heading.x, 0.0f, heading.y))
+            : glm::vec3(1.0f, 0.0f, 0.0f);
+
+        Clock::time_point stepStart = Clock::now();
+        chunkManager.update(waypoints[i].x, waypoints[i].y, options.radius, viewDir);
+        frames += settle(chunkManager, uploadedBytes);
+
+        std::chrono::duration<float, std::milli> stepTime = Clock::now() - stepStart;
+        if (i == 0) {
+            firstStepEnd = Clock::now();
+        } else {
+            slowestStepMs = std::max(slowestStepMs, stepTime.count());
+        }
+    }
+    Clock::time_point end = Clock::now();
+
+    std::chrono::duration<double> total = end - start;
+    std::chrono::duration<double, std::milli> initialLoad = firstStepEnd - start;
+    std::chrono::duration<double, std::milli> streaming = end - firstStepEnd;
+    GenerationCounters jobs = chunkManager.getGenerationCounters();
+    CacheStats cache = chunkManager.getCacheStats();
+    MeshMemory memory = chunkManager.getMeshMemory();
+    int crossings = static_cast<int>(waypoints.size()) - 1;
+
+    std::cout << "path: " << options.path << ", " << options.steps << " steps of "
+              << options.stride << " chunks, radius " << options.radius << ", "
+              << chunkManager.getWorkerCount() << " workers, "
+              << (options.format == VertexFormat::Packed ? "packed" : "float") << " vertices"
+              << (options.compressed ? ", compressed copies" : "") << "\n";
+    std::cout << "chunks generated: " << jobs.completed << " (cancelled " << jobs.cancelled
+              << ", abandoned " << jobs.abandoned << ", stale " << jobs.stale << ")\n";
+    std::cout << "cache hits: " << cache.hits << ", re-uploads: " << cache.reuploads << "\n";
+    std::cout << "total: " << total.count() << " s, " << frames << " frames\n";
+    std::cout << "throughput: " << jobs.completed / total.count() << " chunks/s, "
+              << uploadedBytes / (1024.0 * 1024.0) / total.count() << " MB/s of vertices\n";
+    std::cout << "initial load: " << initialLoad.count() << " ms\n";
+    if (crossings > 0) {
+        std::cout << "per crossing: " << streaming.count() / crossings << " ms avg, "
+                  << slowestStepMs << " ms max\n";
+    }
+    std::cout << "resident: " << memory.vertices << " vertices, "
+              << memory.gpuBytes / (1024.0 * 1024.0) << " MB\n";
+    std::cout << "chunk latency, ms p50 / p99 / max:\n";
+    for (int i = 0; i < PIPELINE_STAGE_COUNT; i++) {
+        PipelineStage stage = static_cast<PipelineStage>(i);
+        const LatencyHistogram& latency = chunkManager.getStageLatency(stage);
+        if (latency.count() == 0) continue;
+        std::cout << "  " << pipelineStageName(stage) << ": " << latency.percentile(50.0) * 1e-3
+                  << " / " << latency.percentile(99.0) * 1e-3 << " / " << latency.max() * 1e-3
+                  << " (" << latency.count() << " chunks)\n";
+    }
+
+    if (!options.latencyPath.empty()) {
+        std::ofstream report(options.latencyPath);
+        if (!report) {
+            std::cerr << "could not write " << options.latencyPath << '\n';
+            return 1;
+        }
+        chunkManager.writePipelineReport(report);
+    }
+    return 0;
+}
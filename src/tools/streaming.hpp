@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+#include "../world/chunk_gen.hpp"
+
+/**
+ * @brief Frame time passed to the upload scheduler by the tools, a steady
+ * 60 fps.
+ */
+inline constexpr float TOOL_FRAME_TIME = 1.0f / 60.0f;
+
+/**
+ * @brief Pumps frames until every requested generation job has ended and its
+ * result left the upload backlog.
+ * @param uploadedBytes Incremented by the vertex bytes uploaded meanwhile.
+ * @return Frames pumped.
+ */
+inline int settle(ChunkManager& chunkManager, std::size_t& uploadedBytes) {
+    int frames = 0;
+    while (true) {
+        GenerationCounters jobs = chunkManager.getGenerationCounters();
+        bool generated = jobs.completed + jobs.cancelled + jobs.abandoned == jobs.requested;
+
+        chunkManager.uploadMesh(TOOL_FRAME_TIME);
+        frames++;
+        UploadStats uploads = chunkManager.getUploadStats();
+        uploadedBytes += uploads.bytesLastFrame;
+
+        // results of every finished job were queued before this frame's upload
+        if (generated && uploads.backlog == 0) return frames;
+        if (uploads.uploadsLastFrame == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
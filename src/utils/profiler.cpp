@@ -0,0 +1,208 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+/*
+Process
+
+1. A zone reads the clock when it opens and again when it closes, then
+   appends {name, start, end, depth} to the ring of the thread's track. The
+   track is found through a thread_local pointer, created and registered under
+   the global lock only on the thread's first zone.
+
+2. Readers (the timeline view, the trace export) copy the events they need
+   out of each ring under that track's lock, so a recording thread waits at
+   most for one copy and never for another recording thread.
+
+3. Tracks outlive their threads: workers that exit leave their events behind
+   until the rings are read. When a thread exits its track is released, and
+   the next thread taking the same name (or the next unnamed one, for tracks
+   never named) continues in it, so resizing the worker pool neither grows
+   memory nor adds lanes to the timeline.
+*/
+
+namespace {
+
+thread_local bool threadNamed = false;
+thread_local int threadDepth = 0;
+
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+}
+
+Profiler& Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+long long Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int Profiler::addTrack(const std::string& name) {
+    std::lock_guard<std::mutex> lock(tracksMutex);
+    return createTrack(name);
+}
+
+int Profiler::createTrack(const std::string& name) {
+    tracks.push_back(std::make_unique<Track>());
+    Track& track = *tracks.back();
+    track.name = name.empty() ? "Thread " + std::to_string(tracks.size()) : name;
+    track.named = !name.empty();
+    track.events.reserve(TRACK_CAPACITY);
+    return static_cast<int>(tracks.size()) - 1;
+}
+
+/**
+ * Holds a thread's track and gives it back when the thread exits.
+ */
+struct Profiler::TrackLease {
+    Track* track = nullptr;
+
+    ~TrackLease() {
+        if (track != nullptr) Profiler::get().releaseTrack(*track);
+    }
+};
+
+Profiler::Track& Profiler::threadTrack(const char* name) {
+    static thread_local TrackLease lease;
+    if (lease.track == nullptr) {
+        std::lock_guard<std::mutex> lock(tracksMutex);
+        // names of tracks in use may change under their own lock, only free ones are compared
+        for (const auto& track : tracks) {
+            if (track->inUse) continue;
+            if (name != nullptr ? track->named && track->name == name : !track->named) {
+                lease.track = track.get();
+                break;
+            }
+        }
+        if (lease.track == nullptr) {
+            lease.track = tracks[createTrack(name != nullptr ? name : "")].get();
+        }
+        lease.track->inUse = true;
+    }
+    return *lease.track;
+}
+
+void Profiler::releaseTrack(Track& track) {
+    std::lock_guard<std::mutex> lock(tracksMutex);
+    track.inUse = false;
+}
+
+void Profiler::setThreadName(const char* name) {
+    if (threadNamed) return;
+    Track& track = threadTrack(name);
+    std::lock_guard<std::mutex> lock(track.mutex);
+    track.name = name;
+    track.named = true;
+    threadNamed = true;
+}
+
+void Profiler::push(Track& track, const ProfileEvent& event) {
+    std::lock_guard<std::mutex> lock(track.mutex);
+    if (track.events.size() < TRACK_CAPACITY) {
+        track.events.push_back(event);
+        return;
+    }
+    track.events[track.next] = event;
+    track.next = (track.next + 1) % TRACK_CAPACITY;
+}
+
+void Profiler::record(const char* name, long long startNs, long long endNs, int depth) {
+    push(threadTrack(), {name, startNs, endNs, depth});
+}
+
+void Profiler::recordOn(int track, const ProfileEvent& event) {
+    Track* target;
+    {
+        std::lock_guard<std::mutex> lock(tracksMutex);
+        target = tracks[track].get();
+    }
+    push(*target, event);
+}
+
+void Profiler::markFrame() {
+    std::lock_guard<std::mutex> lock(framesMutex);
+    frames.push_back(now());
+    if (frames.size() > FRAME_HISTORY) frames.pop_front();
+}
+
+std::vector<long long> Profiler::getFrames() const {
+    std::lock_guard<std::mutex> lock(framesMutex);
+    return std::vector<long long>(frames.begin(), frames.end());
+}
+
+std::vector<TrackSnapshot> Profiler::snapshot(long long fromNs, long long toNs) const {
+    std::vector<Track*> current;
+    {
+        std::lock_guard<std::mutex> lock(tracksMutex);
+        for (const auto& track : tracks) current.push_back(track.get());
+    }
+
+    std::vector<TrackSnapshot> snapshots;
+    for (Track* track : current) {
+        TrackSnapshot snapshot;
+        std::lock_guard<std::mutex> lock(track->mutex);
+        snapshot.name = track->name;
+        // oldest first: the ring starts at next once it is full
+        std::size_t count = track->events.size();
+        for (std::size_t i = 0; i < count; i++) {
+            const ProfileEvent& event = track->events[(track->next + i) % count];
+            if (event.endNs >= fromNs && event.startNs <= toNs) snapshot.events.push_back(event);
+        }
+        snapshots.push_back(std::move(snapshot));
+    }
+    return snapshots;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "[Profiler] Could not write " << path << '\n';
+        return false;
+    }
+
+    std::vector<TrackSnapshot> snapshots = snapshot(0, now());
+    long long origin = now();
+    for (const TrackSnapshot& track : snapshots) {
+        for (const ProfileEvent& event : track.events) origin = std::min(origin, event.startNs);
+    }
+
+    // timestamps and durations are in microseconds
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    for (std::size_t tid = 0; tid < snapshots.size(); tid++) {
+        const TrackSnapshot& track = snapshots[tid];
+        out << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+            << tid << ", \"args\": {\"name\": \"" << escapeJson(track.name) << "\"}}";
+        first = false;
+        for (const ProfileEvent& event : track.events) {
+            out << ",\n{\"name\": \"" << escapeJson(event.name) << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                << tid << ", \"ts\": " << (event.startNs - origin) * 1e-3
+                << ", \"dur\": " << (event.endNs - event.startNs) * 1e-3 << "}";
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+ProfileZone::ProfileZone(const char* name)
+    : name(name), startNs(Profiler::now()), depth(threadDepth++) {}
+
+ProfileZone::~ProfileZone() {
+    threadDepth--;
+    Profiler::get().record(name, startNs, Profiler::now(), depth);
+}
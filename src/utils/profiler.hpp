@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Scoped zone profiler.
+ *
+ * PROFILE_ZONE("name") times the rest of the enclosing scope on the calling
+ * thread, PROFILE_THREAD("name") labels the calling thread's track. Both
+ * compile to nothing when VOXEL_PROFILING is 0 (cmake -DVOXEL_PROFILING=OFF).
+ * Names must be string literals, only the pointer is kept.
+ */
+#ifndef VOXEL_PROFILING
+#define VOXEL_PROFILING 1
+#endif
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if VOXEL_PROFILING
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::get().setThreadName(name)
+#define PROFILE_FRAME() Profiler::get().markFrame()
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
+
+/**
+ * @brief One finished zone, times in nanoseconds of Profiler::now().
+ */
+struct ProfileEvent {
+    const char* name = nullptr;
+    long long startNs = 0;
+    long long endNs = 0;
+    /** Zones open around this one on the same track when it started */
+    int depth = 0;
+};
+
+/**
+ * @brief Events of one track overlapping a time window, oldest first.
+ */
+struct TrackSnapshot {
+    std::string name;
+    std::vector<ProfileEvent> events;
+};
+
+/**
+ * @class Profiler
+ * @brief Collects the zones of every thread into per track rings.
+ *
+ * Each thread gets its own track on its first zone, so recording only takes
+ * the track's own lock, which nobody else holds except while a snapshot is
+ * copied. Tracks of exited threads are handed to the next thread of the same
+ * name. Tracks keep the last TRACK_CAPACITY events, older ones are
+ * overwritten. Other sources such as GPU timer queries add tracks of their
+ * own with addTrack().
+ *
+ * Frames are delimited by markFrame() on the main thread, the last
+ * FRAME_HISTORY frame starts are kept for the timeline view.
+ */
+class Profiler {
+    public:
+        static constexpr std::size_t TRACK_CAPACITY = 16384;
+        static constexpr std::size_t FRAME_HISTORY = 240;
+
+        static Profiler& get();
+
+        /** @return Nanoseconds on the steady clock. */
+        static long long now();
+
+        /**
+         * @brief Names the calling thread's track, keeps the first name given.
+         */
+        void setThreadName(const char* name);
+        /**
+         * @brief Records a finished zone of the calling thread.
+         */
+        void record(const char* name, long long startNs, long long endNs, int depth);
+
+        /**
+         * @brief Adds a track not tied to a thread, named "Thread N" if the
+         * name is empty.
+         * @return Id for recordOn().
+         */
+        int addTrack(const std::string& name);
+        void recordOn(int track, const ProfileEvent& event);
+
+        /**
+         * @brief Starts a new frame of the timeline.
+         */
+        void markFrame();
+        /**
+         * @return Start times of the kept frames, oldest first. The last one
+         * is the frame in progress.
+         */
+        std::vector<long long> getFrames() const;
+
+        /**
+         * @return Every track with its events overlapping [fromNs, toNs].
+         */
+        std::vector<TrackSnapshot> snapshot(long long fromNs, long long toNs) const;
+
+        /**
+         * @brief Writes every kept event as Chrome trace-event JSON, which
+         * chrome://tracing and ui.perfetto.dev open.
+         * @return False if the file could not be written.
+         */
+        bool writeChromeTrace(const std::string& path) const;
+
+    private:
+        struct Track {
+            std::string name;
+            /* Set by setThreadName() or addTrack(), otherwise named by number */
+            bool named = false;
+            /* Held by a live thread or added with addTrack(), guarded by tracksMutex */
+            bool inUse = true;
+            mutable std::mutex mutex;
+            std::vector<ProfileEvent> events;
+            /* Slot the next event goes to once the ring is full */
+            std::size_t next = 0;
+        };
+        struct TrackLease;
+
+        Profiler() = default;
+
+        /**
+         * @brief The calling thread's track, on the first call a released
+         * track of the same name (any never named one without a name) or a
+         * new one.
+         */
+        Track& threadTrack(const char* name = nullptr);
+        void releaseTrack(Track& track);
+        /** @return Id of a new track, tracksMutex must be held. */
+        int createTrack(const std::string& name);
+        static void push(Track& track, const ProfileEvent& event);
+
+        mutable std::mutex tracksMutex;
+        std::vector<std::unique_ptr<Track>> tracks;
+
+        mutable std::mutex framesMutex;
+        std::deque<long long> frames;
+};
+
+/**
+ * @class ProfileZone
+ * @brief Records the time between its construction and destruction, use
+ * through PROFILE_ZONE.
+ */
+class ProfileZone {
+    public:
+        explicit ProfileZone(const char* name);
+        ~ProfileZone();
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+    private:
+        const char* name;
+        long long startNs;
+        int depth;
+};
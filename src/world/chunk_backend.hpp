@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "../noise/perlin_gen.hpp"
+#include "../render/range_allocator.hpp"
+#include "../render/staging_ring.hpp"
+
+class Shader;
+
+/**
+ * @brief Snapshot of the GPU side of chunk meshes.
+ */
+struct BackendStats {
+    ArenaStats arena;
+    StagingStats staging;
+    /** Index buffer shared by every chunk. */
+    std::size_t indexBytes = 0;
+};
+
+/**
+ * @brief Draw submissions of one pass.
+ */
+struct SubmitStats {
+    int drawCalls = 0;
+    int drawRanges = 0;
+};
+
+/**
+ * @class ChunkBackend
+ * @brief GPU side of ChunkManager: keeps uploaded chunk meshes and draws
+ * ranges of their quads.
+ *
+ * ChunkManager does the world bookkeeping, threading and culling and reaches
+ * the GPU only through this interface, so it builds and runs without a
+ * graphics context when given a NullBackend (null_backend.hpp). The OpenGL
+ * implementation is GlChunkBackend (gl_chunk_backend.hpp).
+ *
+ * stage() may be called from any thread. Every other method runs on the
+ * render thread.
+ */
+class ChunkBackend {
+    public:
+        virtual ~ChunkBackend() = default;
+
+        /**
+         * @brief Switches the vertex layout of new meshes. Only called while
+         * no mesh is resident.
+         */
+        virtual void setVertexFormat(VertexFormat format) = 0;
+
+        /**
+         * @brief Copies a finished mesh into upload memory, from the worker
+         * that built it.
+         * @return False if there was no room, the mesh is uploaded from its
+         * CPU vertices then.
+         */
+        virtual bool stage(const ChunkMesh& mesh, StagingBlock& block) = 0;
+        /**
+         * @brief Starts the frame's uploads.
+         */
+        virtual void beginUploads() = 0;
+        /**
+         * @return True once a staged block can be uploaded from.
+         */
+        virtual bool isReadable(const StagingBlock& block) const = 0;
+        /**
+         * @brief Gives back a staged block that will never be uploaded.
+         */
+        virtual void dropStaged(const StagingBlock& block) = 0;
+        /**
+         * @brief Makes a mesh resident, from its staged block if it has one,
+         * from its vertices otherwise.
+         * @param origin World position of the chunk the mesh is relative to.
+         * @return Handle of the resident mesh.
+         */
+        virtual int upload(const ChunkMesh& mesh, const StagingBlock& staging,
+                           const glm::ivec3& origin) = 0;
+        virtual void release(int handle) = 0;
+        /**
+         * @brief Ends the frame's uploads.
+         */
+        virtual void endUploads() = 0;
+
+        /**
+         * @brief Prepares a pass drawn with a shader that is already in use.
+         */
+        virtual void beginPass(const Shader& shader) = 0;
+        /**
+         * @return Group of a resident mesh. Meshes of one group are submitted
+         * together, so draws are issued sorted by group.
+         */
+        virtual int batchGroup(int handle) const = 0;
+        /**
+         * @return Number of groups, draws need no sorting while it is 1.
+         */
+        virtual int batchGroupCount() const = 0;
+        /**
+         * @brief Queues quads [firstQuad, firstQuad + quads) of a resident mesh.
+         */
+        virtual void draw(int handle, std::size_t firstQuad, std::size_t quads) = 0;
+        /**
+         * @brief Submits everything queued since beginPass().
+         */
+        virtual SubmitStats endPass() = 0;
+
+        virtual BackendStats getStats() const = 0;
+};
@@ -1,47 +1,110 @@
 #include "chunk_gen.hpp"
 #include "../noise/perlin_gen.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <math.h>
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "mesh_codec.hpp"
+#include "null_backend.hpp"
+#include "../utils/profiler.hpp"
+
 /*
 Process
 
 1. Determine the set of chunk coordinates that should be visible
    based on the player's current chunk position and render distance.
    This forms a square grid of chunks centered around the player.
+   - Nothing happens until the player enters another chunk or the render
+     distance changes, so a frame without either costs O(1).
+   - Otherwise only the difference between the previously loaded square and
+     the new one is visited (forEachOutside): strips of O(r) chunks when
+     crossing into a neighbor, and everything that changed for teleports and
+     render distance changes.
 
-2. Iterate over this target grid and check whether each required
-   chunk already exists in the world map.
-   - If a chunk is missing, generate its terrain data using Perlin noise
-     and insert it into the world container.
-   - Newly created chunks are marked as not ready (buffers not uploaded yet).
+2. Chunks are loaded within the render distance but only evicted once they
+   leave a square UNLOAD_MARGIN chunks larger (the evict square), so border
+   jitter does not churn the edge row. Chunks of the old evict square outside
+   the new one are evicted.
+   - Uploaded chunks move into a bounded LRU cache (lru_cache.hpp) together
+     with their mesh and GPU range. Only chunks pushed out of the cache, or
+     evicted before their upload, release their range.
+   - Their cancel token is set, so queued requests are dropped and workers
+     abandon meshes that are still being built.
+   - The world is a toroidal grid (toroidal_grid.hpp) of 2 * evict radius
+     + 1 chunks per side, indexed by chunk coordinate modulo the side. A
+     chunk leaving one edge frees exactly the cell the chunk entering at the
+     opposite edge needs, which is why evicting happens first.
 
-3. Iterate through all currently loaded chunks in the world.
-   - Identify chunks that fall outside the render distance.
-   - For those chunks, we delete their OpenGL resources (VAO/VBO)
-     if they were uploaded we remove them from the world map to free memory.
+3. Chunks of the new load square outside the old one are inserted, unless
+   they are still loaded from within the margin.
+   - Chunks found in the cache are moved back as they were, which makes
+     lowering and raising the render distance cheap.
+   - Otherwise their terrain data is generated using Perlin noise.
+   - Newly created chunks are marked as not ready (buffers not uploaded yet).
+   - Their meshes are built by a pool of worker threads (worker_pool.hpp).
+     Requests are ordered by distance to the player and angle to the view
+     direction, and reordered whenever the player enters a new chunk, so the
+     chunks in front of the camera fill first.
 
 4. After update():
-   - uploadMesh() uploads vertex data of newly generated chunks to the GPU
-     and sets up their VAO/VBO state.
+   - uploadMesh() uploads vertex data of newly generated chunks to the GPU.
+     Finished meshes wait in a pending list and are uploaded oldest first
+     within a per-frame time budget, which grows while frames hit the target
+     frame time and is halved when they do not, and a byte cap.
+   - Chunks without any faces become ready without a GPU range or culling
+     box, so they count as resident but are never drawn.
+   - Once uploaded, a chunk keeps only its vertex count, face ranges and
+     GPU range. The CPU vertices are released. With compressed copies
+     enabled, workers also compress each mesh (mesh_codec.hpp), and chunks
+     moving into the cache give up their GPU range and are re-uploaded from
+     the compressed copy when they return.
+   - Everything touching the GPU goes through a ChunkBackend
+     (chunk_backend.hpp), so this file builds without OpenGL. The game uses
+     GlChunkBackend (gl_chunk_backend.hpp): workers copy finished meshes into
+     a mapped staging ring and free the CPU vertices of every staged mesh
+     (unstaged ones keep them for a direct upload), the render thread only
+     issues GPU side copies
+     into a paged vertex arena, and one element buffer with the quad index
+     pattern serves every mesh. Headless runs use NullBackend, which only
+     keeps statistics.
 
 5. During render():
    - Only chunks marked as ready are drawn.
-   - Each chunk binds its VAO and issues a draw call.
+   - Every uploaded chunk has a box in a structure-of-arrays list (BoxList,
+     frustum.hpp) spanning the chunk's columns and the height range its mesh
+     covers. The list is tested against the camera frustum in one pass and
+     chunks fully outside are skipped. The shadow pass does the same with
+     the light's orthographic view-projection.
+   - Each chunk queues index ranges for the face directions that can face
+     the viewer. Meshes keep the quads of each direction together, so a
+     direction facing away is skipped as a whole.
+   - Visible chunks are sorted by the backend's batch group (the arena page
+     for GlChunkBackend) and each group is submitted with one multi-draw
+     call. Packed positions are relative to the chunk, the backend supplies
+     the chunk origin to the vertex shader.
+
+6. Latency instrumentation:
+   - Every chunk carries ChunkTimestamps from its request in update()
+     through the worker, the upload queue and the upload to its first draw
+     by the terrain pass. Spans between them are recorded into one
+     LatencyHistogram per PipelineStage, all on the render thread: queue wait
+     and generation when the result is taken off the upload queue, stale or
+     not, the rest at upload and first draw. Chunks coming back from the
+     cache are not measured again.
+   - Workers add up the time they spend generating, which is turned into a
+     utilization once per UTILIZATION_WINDOW.
 */
 
 /**
- * Helper to generate a unique key single for unordered_map from two coords
+ * Helper to generate a unique key single for a chunk from two coords
  *
  * getChunkKey(int x, int z) packs two 32-bit chunk coordinates into a single
  * 64-bit integer by placing x in the upper 32 bits and z in the lower 32 bits,
- * producing a unique key that can be used in an unordered_map<long long, Chunk>
- * for fast lookup of chunks.
+ * producing a unique key that identifies a chunk across loads.
  * @param x
  * @param y
  * @return
@@ -51,195 +114,995 @@ static long long getChunkKey(int x, int z)
     return (static_cast<long long>(x) << 32) | (z & 0xffffffff);
 }
 
-ChunkManager::ChunkManager()
+/**
+ * Width and length of a chunk in blocks, the distance between chunk origins.
+ */
+static constexpr int CHUNK_SIZE = 16;
+
+/**
+ * Chunks within this many chunks of the player and in front of the camera
+ * make up the "first visible ring" used for the load-time metric.
+ */
+static constexpr int FIRST_RING_RADIUS = 2;
+
+/**
+ * Chunks are generated within the render distance but only evicted once they
+ * are this many chunks further out, so walking back and forth over a chunk
+ * border does not unload and regenerate the edge row.
+ */
+static constexpr int UNLOAD_MARGIN = 2;
+
+/**
+ * Evicted chunks kept around with their GPU buffers. Enough to hold the rings
+ * dropped when lowering the render distance by a few steps.
+ */
+static constexpr std::size_t CHUNK_CACHE_CAPACITY = 1024;
+
+/**
+ * Period over which worker utilization is averaged.
+ */
+static constexpr std::chrono::milliseconds UTILIZATION_WINDOW{1000};
+
+const char* pipelineStageName(PipelineStage stage)
 {
-    workerThread = std::thread(
-        [this]()
-        {
-            while (running)
-            {
-                GenerationRequest req;
-                {
-                    std::unique_lock<std::mutex> lock(queueMutex);
-                    cv.wait(lock, [this]()
-                            { return !generationQueue.empty() || !running; });
-                    if (!running)
-                        break;
-                    req = generationQueue.front();
-                    generationQueue.pop();
-                }
-
-                GenerationResult result;
-                result.key = req.key;
-                result.vertices = PerlinGen::generate(0.05f, req.x, req.z);
-
-                {
-                    std::lock_guard<std::mutex> lock(uploadMutex);
-                    uploadQueue.push(std::move(result));
-                }
-            }
-        });
+    switch (stage)
+    {
+    case PipelineStage::QueueWait:
+        return "queue_wait";
+    case PipelineStage::Generation:
+        return "generation";
+    case PipelineStage::UploadWait:
+        return "upload_wait";
+    case PipelineStage::Upload:
+        return "upload";
+    case PipelineStage::DrawWait:
+        return "draw_wait";
+    case PipelineStage::Ready:
+        return "ready";
+    case PipelineStage::Visible:
+        return "visible";
+    case PipelineStage::Count:
+        break;
+    }
+    return "";
+}
+
+/**
+ * Scheduling score for a chunk at offset (dx, dz) from the player chunk.
+ * Chunks straight ahead are scored by their distance, chunks behind the camera
+ * count as up to twice as far away.
+ */
+static float chunkPriority(int dx, int dz, const glm::vec3& viewDir)
+{
+    float distance = std::sqrt(static_cast<float>(dx * dx + dz * dz));
+    if (distance == 0.0f)
+        return 0.0f;
+
+    glm::vec2 forward(viewDir.x, viewDir.z);
+    float forwardLength = glm::length(forward);
+    float facing = 0.0f;
+    if (forwardLength > 1e-4f)
+        facing = glm::dot(glm::vec2(dx, dz) / distance, forward / forwardLength);
+
+    return distance * (1.5f - 0.5f * facing);
+}
+
+ChunkManager::ChunkManager(std::unique_ptr<ChunkBackend> backend)
+    : evictedChunks(CHUNK_CACHE_CAPACITY, [this](Chunk& chunk) { unload(chunk); }),
+      uploadBudgetMs(INITIAL_UPLOAD_BUDGET_MS),
+      utilizationStart(std::chrono::steady_clock::now()),
+      backend(std::move(backend)),
+      workers([this](GenerationRequest& req) { generate(req); })
+{
+    this->backend->setVertexFormat(vertexFormat);
+}
+
+ChunkManager::~ChunkManager() {}
+
+/**
+ * Runs on a worker thread: builds the chunk mesh and hands it to the render
+ * thread through the upload queue.
+ */
+void ChunkManager::generate(GenerationRequest& req)
+{
+    PROFILE_THREAD("Chunk worker");
+    PROFILE_ZONE("Generate chunk");
+    if (req.cancelled->load())
+    {
+        cancelledJobs++;
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    GenerationResult result;
+    result.x = req.x;
+    result.z = req.z;
+    result.key = req.key;
+    result.epoch = req.epoch;
+    result.times = req.times;
+    result.times.generationStarted = Clock::now();
+    generatingJobs++;
+    auto endJob = [&](Clock::time_point end)
+    {
+        workerBusyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            end - result.times.generationStarted)
+                            .count();
+        generatingJobs--;
+    };
+    {
+        PROFILE_ZONE("Build mesh");
+        result.mesh = PerlinGen::generate(0.05f, req.x, req.z, req.format,
+                                          req.cancelled.get());
+    }
+
+    if (req.cancelled->load())
+    {
+        endJob(Clock::now());
+        abandonedJobs++;
+        return;
+    }
+
+    bool staged;
+    {
+        PROFILE_ZONE("Stage mesh");
+        staged = backend->stage(result.mesh, result.staging);
+    }
+    if (req.compress && result.mesh.vertexCount() > 0)
+    {
+        PROFILE_ZONE("Compress mesh");
+        result.compressed = compressVertices(result.mesh.data(), result.mesh.vertexCount(),
+                                             result.mesh.stride());
+    }
+    // the upload copies from staging memory, only counts are needed until then
+    if (staged)
+        result.mesh.releaseVertices();
+    result.times.generated = Clock::now();
+    endJob(result.times.generated);
+
+    std::lock_guard<std::mutex> lock(uploadMutex);
+    uploadQueue.push(std::move(result));
+    // counted once queued, so the next uploadMesh() sees every completed job
+    completedJobs++;
 }
 
-ChunkManager::~ChunkManager()
+/**
+ * Cancels outstanding work for a chunk and frees its GPU range.
+ */
+void ChunkManager::unload(Chunk& chunk)
 {
-    running = false;
-    cv.notify_one();
-    if (workerThread.joinable())
-        workerThread.join();
+    chunk.cancelled->store(true);
+    if (chunk.boundsIndex != -1)
+        removeBounds(chunk);
+    if (chunk.ready)
+        releaseGpuMesh(chunk);
+    compressedBytes -= chunk.compressed.size();
+}
+
+/**
+ * Gives back a chunk's GPU range. It is no longer drawable afterwards.
+ */
+void ChunkManager::releaseGpuMesh(Chunk& chunk)
+{
+    if (chunk.meshHandle != -1)
+        backend->release(chunk.meshHandle);
+    chunk.meshHandle = -1;
+    chunk.ready = false;
+    residentChunks--;
+    residentVertices -= chunk.vertexCount;
+    gpuMeshBytes -= chunk.vertexCount * chunk.mesh.stride();
+}
+
+/**
+ * Queues a chunk restored from the cache without a GPU range for upload. Its
+ * vertices are decompressed when the upload's turn comes.
+ */
+void ChunkManager::queueReupload(int slot)
+{
+    const Chunk& chunk = world.at(slot);
+    glm::ivec2 coord = world.coord(slot);
+
+    GenerationResult result;
+    result.x = coord.x;
+    result.z = coord.y;
+    result.key = getChunkKey(coord.x, coord.y);
+    result.epoch = chunk.epoch;
+    result.restore = true;
+    result.times.generated = std::chrono::steady_clock::now();
+    pendingUploads.push_back(std::move(result));
+    cacheReuploads++;
 }
 
 /**
  * @param playerChunk_x
  * @param playerChunk_z
  * @param render_distance Render distance of world.
+ * @param viewDir Camera front vector, used to prioritize generation.
  * @return void
  */
 void ChunkManager::update(const int playerChunk_x, const int playerChunk_z,
-                          const int render_distance)
+                          const int render_distance, const glm::vec3& viewDir)
 {
-    for (int dx = -render_distance; dx <= render_distance; ++dx)
-    {
-        for (int dz = -render_distance; dz <= render_distance; ++dz)
-        {
-            int x_shifted = playerChunk_x + dx;
-            int z_shifted = playerChunk_z + dz;
+    bool crossedChunk = !hasPlayerChunk || playerChunk_x != lastPlayerChunk_x ||
+                        playerChunk_z != lastPlayerChunk_z;
+    if (!crossedChunk && render_distance == loadedRadius)
+        return;
+    PROFILE_ZONE("Stream chunks");
 
-            long long key = getChunkKey(x_shifted, z_shifted);
+    glm::ivec2 oldCenter(lastPlayerChunk_x, lastPlayerChunk_z);
+    glm::ivec2 center(playerChunk_x, playerChunk_z);
+    int oldRadius = loadedRadius;
+    int oldEvictRadius = oldRadius < 0 ? -1 : oldRadius + UNLOAD_MARGIN;
+    int evictRadius = render_distance + UNLOAD_MARGIN;
 
-            // Add new chunk in range
-            if (world.find(key) == world.end())
+    if (crossedChunk)
+    {
+        workers.reprioritize(
+            [&](const GenerationRequest& req)
             {
-                Chunk chunk;
-                chunk.coord = {x_shifted, z_shifted};
+                return chunkPriority(req.x - playerChunk_x,
+                                     req.z - playerChunk_z, viewDir);
+            });
+        lastPlayerChunk_x = playerChunk_x;
+        lastPlayerChunk_z = playerChunk_z;
+        hasPlayerChunk = true;
+    }
 
-                chunk.ready = false;
-                world.emplace(key, std::move(chunk));
+    // Every loaded chunk lies within the old evict square. Those outside the
+    // new one go first, freeing the grid cells that the chunks entering on
+    // the opposite edge wrap around into
+    bool unloadedAny = false;
+    if (oldEvictRadius >= 0)
+    {
+        forEachOutside(oldCenter, oldEvictRadius, center, evictRadius,
+                       [&](int x, int z)
+                       {
+                           if (world.find(x, z) == nullptr)
+                               return;
+                           evict(world.slot(x, z));
+                           unloadedAny = true;
+                       });
+    }
 
-                {
-                    std::lock_guard<std::mutex> lock(queueMutex);
-                    generationQueue.push({x_shifted, z_shifted, key});
-                }
-                cv.notify_one();
-            }
-        }
+    if (unloadedAny)
+    {
+        cancelledJobs += workers.removeIf([](const GenerationRequest& req)
+                                          { return req.cancelled->load(); });
     }
 
-    for (auto it = world.begin(); it != world.end();)
+    int side = 2 * evictRadius + 1;
+    if (side != world.side())
     {
-        int chunkX = static_cast<int>(it->second.coord.x);
-        int chunkZ = static_cast<int>(it->second.coord.y);
+        world.resize(side);
+        rebuildBounds();
+    }
 
-        if (std::abs(chunkX - playerChunk_x) > render_distance ||
-            std::abs(chunkZ - playerChunk_z) > render_distance)
+    // Chunks entering the load square may still be loaded from an earlier
+    // visit (kept by the evict margin) or waiting in the cache
+    std::vector<GenerationRequest> requests;
+    std::chrono::steady_clock::time_point requestedAt = std::chrono::steady_clock::now();
+    forEachOutside(
+        center, render_distance, oldCenter, oldRadius,
+        [&](int x_shifted, int z_shifted)
         {
+            if (world.find(x_shifted, z_shifted) != nullptr)
+                return;
 
-            if (it->second.ready)
+            long long key = getChunkKey(x_shifted, z_shifted);
+            Chunk& chunk = world.insert(x_shifted, z_shifted);
+            if (std::optional<Chunk> cached = evictedChunks.take(key))
             {
-                glDeleteVertexArrays(1, &it->second.VAO);
-                glDeleteBuffers(1, &it->second.VBO);
+                chunk = std::move(*cached);
+                chunk.drawn = true; // measured on its first visit
+                if (chunk.ready)
+                    addBounds(world.slot(x_shifted, z_shifted));
+                else
+                    queueReupload(world.slot(x_shifted, z_shifted));
+                cacheHits++;
+                return;
             }
+            cacheMisses++;
+
+            chunk.coord = {x_shifted, z_shifted};
+            chunk.epoch = nextEpoch++;
+            chunk.cancelled = std::make_shared<std::atomic<bool>>(false);
+
+            chunk.ready = false;
+            chunk.times.requested = requestedAt;
+
+            GenerationRequest req;
+            req.x = x_shifted;
+            req.z = z_shifted;
+            req.key = key;
+            req.epoch = chunk.epoch;
+            req.cancelled = chunk.cancelled;
+            req.format = vertexFormat;
+            req.compress = compressedCopies;
+            req.priority = chunkPriority(x_shifted - playerChunk_x,
+                                         z_shifted - playerChunk_z, viewDir);
+            req.times.requested = requestedAt;
+            requests.push_back(std::move(req));
+        });
+    loadedRadius = render_distance;
+
+    requestedJobs += static_cast<int>(requests.size());
+    workers.submitBatch(requests);
+
+    if (crossedChunk)
+        startFirstRingTimer(playerChunk_x, playerChunk_z, viewDir);
+}
 
-            it = world.erase(it);
+/**
+ * Removes a chunk from the world. Uploaded chunks move to the cache with
+ * their buffers, anything still generating is cancelled and dropped.
+ */
+void ChunkManager::evict(int slot)
+{
+    Chunk& chunk = world.at(slot);
+    evictions++;
+    if (chunk.ready)
+    {
+        if (chunk.boundsIndex != -1)
+            removeBounds(chunk);
+        if (compressedCopies && !chunk.compressed.empty())
+            releaseGpuMesh(chunk);
+        glm::ivec2 coord = world.coord(slot);
+        evictedChunks.put(getChunkKey(coord.x, coord.y), std::move(chunk));
+    }
+    else
+    {
+        unload(chunk);
+    }
+    world.erase(slot);
+}
+
+/**
+ * Starts timing how long the chunks around and in front of the player take to
+ * become visible. Nothing is measured when they are all resident already.
+ */
+void ChunkManager::startFirstRingTimer(int playerChunk_x, int playerChunk_z,
+                                       const glm::vec3& viewDir)
+{
+    firstRingChunks.clear();
+    for (int dx = -FIRST_RING_RADIUS; dx <= FIRST_RING_RADIUS; ++dx)
+    {
+        for (int dz = -FIRST_RING_RADIUS; dz <= FIRST_RING_RADIUS; ++dz)
+        {
+            bool inFront = dx * viewDir.x + dz * viewDir.z >= 0.0f;
+            if (!inFront && (std::abs(dx) > 1 || std::abs(dz) > 1))
+                continue;
+            firstRingChunks.push_back(
+                glm::ivec2(playerChunk_x + dx, playerChunk_z + dz));
         }
-        else
+    }
+
+    firstRingPending = false;
+    for (const glm::ivec2& coord : firstRingChunks)
+    {
+        const Chunk* chunk = world.find(coord.x, coord.y);
+        if (chunk == nullptr || !chunk->ready)
         {
-            ++it;
+            firstRingPending = true;
+            firstRingStart = std::chrono::steady_clock::now();
+            break;
         }
     }
 }
 
-void ChunkManager::uploadMesh()
+void ChunkManager::checkFirstRingTimer()
 {
-    int uploadsThisFrame = 0;
+    if (!firstRingPending)
+        return;
 
+    for (const glm::ivec2& coord : firstRingChunks)
+    {
+        const Chunk* chunk = world.find(coord.x, coord.y);
+        if (chunk == nullptr || !chunk->ready)
+            return;
+    }
+
+    std::chrono::duration<float, std::milli> elapsed =
+        std::chrono::steady_clock::now() - firstRingStart;
+    firstRingTime = elapsed.count();
+    firstRingPending = false;
+}
+
+/**
+ * Decompresses a chunk's vertices back into its mesh for re-upload.
+ */
+static void restoreVertices(Chunk& chunk)
+{
+    ChunkMesh& mesh = chunk.mesh;
+    void* out;
+    if (mesh.format == VertexFormat::Packed)
+    {
+        mesh.packedVertices.resize(chunk.vertexCount);
+        out = mesh.packedVertices.data();
+    }
+    else
+    {
+        mesh.vertices.resize(chunk.vertexCount);
+        out = mesh.vertices.data();
+    }
+    decompressVertices(chunk.compressed, out, chunk.vertexCount, mesh.stride());
+}
+
+/**
+ * Moves finished results to the pending list and uploads the oldest ones until
+ * the frame's time or byte budget is spent. At least one mesh is uploaded per
+ * frame so streaming never stalls.
+ *
+ * The time budget grows additively while frames stay within the target and is
+ * halved once a frame runs long, so it settles just below the point where
+ * uploads start costing frames.
+ */
+void ChunkManager::uploadMesh(float frameTime)
+{
+    using Clock = std::chrono::steady_clock;
+
+    if (frameTime > TARGET_FRAME_TIME * FRAME_TIME_TOLERANCE)
+        uploadBudgetMs = std::max(uploadBudgetMs * 0.5f, MIN_UPLOAD_BUDGET_MS);
+    else
+        uploadBudgetMs = std::min(uploadBudgetMs + UPLOAD_BUDGET_STEP_MS,
+                                  MAX_UPLOAD_BUDGET_MS);
+
+    backend->beginUploads();
     {
         std::lock_guard<std::mutex> lock(uploadMutex);
-        while (!uploadQueue.empty() && uploadsThisFrame < 4)
+        while (!uploadQueue.empty())
         {
-            GenerationResult result = std::move(uploadQueue.front());
+            const ChunkTimestamps& times = uploadQueue.front().times;
+            recordLatency(PipelineStage::QueueWait, times.requested, times.generationStarted);
+            recordLatency(PipelineStage::Generation, times.generationStarted, times.generated);
+            pendingUploadBytes += uploadQueue.front().mesh.byteSize();
+            pendingUploads.push_back(std::move(uploadQueue.front()));
             uploadQueue.pop();
-
-            auto it = world.find(result.key);
-            if (it == world.end())
-                continue; // chunk was unloaded before upload
-
-            Chunk& chunk = it->second;
-            chunk.vertices = std::move(result.vertices);
-            uploadsThisFrame++;
         }
     }
+    sampleUtilization();
 
-    for (auto& [key, chunk] : world)
+    Clock::time_point start = Clock::now();
+    int uploads = 0;
+    std::size_t bytes = 0;
+    while (!pendingUploads.empty())
     {
-        if (!chunk.ready && !chunk.vertices.empty())
+        std::chrono::duration<float, std::milli> elapsed = Clock::now() - start;
+        if (uploads > 0 &&
+            (elapsed.count() >= uploadBudgetMs || bytes >= MAX_UPLOAD_BYTES_PER_FRAME))
+            break;
+
+        GenerationResult result = std::move(pendingUploads.front());
+        pendingUploads.pop_front();
+
+        Chunk* found = world.find(result.x, result.z);
+        if (found == nullptr || found->epoch != result.epoch)
         {
-            glGenVertexArrays(1, &chunk.VAO);
-            glGenBuffers(1, &chunk.VBO);
+            pendingUploadBytes -= result.mesh.byteSize();
+            dropResult(result); // chunk was unloaded before upload
+            continue;
+        }
+        if (result.staging.segment != -1 && !backend->isReadable(result.staging))
+        {
+            // another worker is still writing to the same segment
+            deferredUploads.push_back(std::move(result));
+            continue;
+        }
+        pendingUploadBytes -= result.mesh.byteSize();
 
-            glBindVertexArray(chunk.VAO);
-            glBindBuffer(GL_ARRAY_BUFFER, chunk.VBO);
+        Chunk& chunk = *found;
+        if (result.restore)
+        {
+            restoreVertices(chunk);
+        }
+        else
+        {
+            chunk.mesh = std::move(result.mesh);
+            compressedBytes += result.compressed.size();
+            chunk.compressed = std::move(result.compressed);
+        }
 
-            glBufferData(GL_ARRAY_BUFFER,
-                         chunk.vertices.size() * sizeof(Vertex),
-                         chunk.vertices.data(), GL_STATIC_DRAW);
+        result.times.uploadStarted = Clock::now();
+        uploadChunk(world.slot(result.x, result.z), result.staging);
+        if (chunk.meshHandle != -1)
+        {
+            uploads++;
+            bytes += chunk.vertexCount * chunk.mesh.stride();
+        }
+        result.times.uploaded = Clock::now();
+        if (!result.restore)
+        {
+            const ChunkTimestamps& times = result.times;
+            recordLatency(PipelineStage::UploadWait, times.generated, times.uploadStarted);
+            recordLatency(PipelineStage::Upload, times.uploadStarted, times.uploaded);
+            recordLatency(PipelineStage::Ready, times.requested, times.uploaded);
+            chunk.times = times;
+            // chunks without faces are never drawn, nothing to wait for
+            chunk.drawn = chunk.meshHandle == -1;
+        }
 
-            // Vertex positions
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                                  (void*)0);
-            glEnableVertexAttribArray(0);
+        std::chrono::duration<float, std::milli> latency = result.times.uploaded - result.times.generated;
+        uploadStats.latencyAvgMs = uploadStats.latencyAvgMs == 0.0f
+            ? latency.count()
+            : uploadStats.latencyAvgMs + (latency.count() - uploadStats.latencyAvgMs) * 0.1f;
+        uploadStats.latencyMaxMs = std::max(uploadStats.latencyMaxMs, latency.count());
+    }
 
-            // Normals
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                                  (void*)offsetof(Vertex, normal));
-            glEnableVertexAttribArray(1);
+    for (auto it = deferredUploads.rbegin(); it != deferredUploads.rend(); ++it)
+        pendingUploads.push_front(std::move(*it));
+    deferredUploads.clear();
+    backend->endUploads();
 
-            // Texture coordinates
-            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                                  (void*)offsetof(Vertex, tex));
-            glEnableVertexAttribArray(2);
+    std::chrono::duration<float, std::milli> spent = Clock::now() - start;
+    uploadStats.uploadsLastFrame = uploads;
+    uploadStats.bytesLastFrame = bytes;
+    uploadStats.uploadMsLastFrame = spent.count();
+    uploadStats.budgetMs = uploadBudgetMs;
+    uploadStats.backlog = static_cast<int>(pendingUploads.size());
+    uploadStats.backlogBytes = pendingUploadBytes;
 
-            // Texture id
-            glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                                  (void*)offsetof(Vertex, texID));
-            glEnableVertexAttribArray(3);
+    checkFirstRingTimer();
+}
 
-            chunk.ready = true;
-        }
+/**
+ * Hands the mesh of the chunk in a world slot to the backend and makes it
+ * drawable. Chunks without faces become ready without a GPU range.
+ */
+void ChunkManager::uploadChunk(int slot, const StagingBlock& staging)
+{
+    PROFILE_ZONE("Upload chunk");
+    Chunk& chunk = world.at(slot);
+    chunk.ready = true;
+    residentChunks++;
+    if (chunk.mesh.vertexCount() == 0)
+    {
+        chunk.meshHandle = -1;
+        chunk.vertexCount = 0;
+        return;
     }
+
+    glm::ivec2 coord = world.coord(slot);
+    chunk.meshHandle = backend->upload(
+        chunk.mesh, staging, glm::ivec3(coord.x * CHUNK_SIZE, 0, coord.y * CHUNK_SIZE));
+    addBounds(slot);
+    chunk.vertexCount = static_cast<std::uint32_t>(chunk.mesh.vertexCount());
+    residentVertices += chunk.vertexCount;
+    gpuMeshBytes += chunk.mesh.byteSize();
+
+    // the GPU copy is authoritative from here on
+    chunk.mesh.releaseVertices();
 }
 
-void ChunkManager::render()
+/**
+ * Discards a result that will never be uploaded, giving back its staging
+ * block.
+ */
+void ChunkManager::dropResult(const GenerationResult& result)
+{
+    if (result.staging.segment != -1)
+        backend->dropStaged(result.staging);
+    staleResults++;
+}
+
+/**
+ * Culls the uploaded chunks against a view volume and fills drawList with the
+ * rest, sorted by batch group so each group is submitted once.
+ */
+void ChunkManager::collectVisible(const glm::mat4& viewProjection, PassStats& stats)
+{
+    PROFILE_ZONE("Cull chunks");
+    Frustum(viewProjection).cull(chunkBounds, chunkVisible);
+
+    drawList.clear();
+    for (std::size_t i = 0; i < boundsOwners.size(); ++i)
+    {
+        if (chunkVisible[i])
+            drawList.push_back(boundsOwners[i]);
+        else
+            stats.chunksCulled++;
+    }
+    stats.chunksDrawn = static_cast<int>(drawList.size());
+
+    if (backend->batchGroupCount() > 1)
+    {
+        std::sort(drawList.begin(), drawList.end(),
+                  [this](int a, int b)
+                  {
+                      return backend->batchGroup(world.at(a).meshHandle) <
+                             backend->batchGroup(world.at(b).meshHandle);
+                  });
+    }
+}
+
+/**
+ * Queues the face direction buckets of a chunk selected by faceMask, one bit
+ * per Face, with the backend. Buckets are stored in Face order, so
+ * neighboring visible buckets are joined into a single range.
+ */
+void ChunkManager::drawChunk(const Chunk& chunk, unsigned int faceMask,
+                             PassStats& stats)
 {
-    for (auto& [key, chunk] : world)
+    const ChunkMesh& mesh = chunk.mesh;
+
+    int face = 0;
+    while (face < FACE_COUNT)
     {
-        if (!chunk.ready)
+        if (!(faceMask & (1u << face)))
+        {
+            stats.trianglesSkipped += mesh.faceQuadCount[face] * 2;
+            face++;
             continue;
-        glBindVertexArray(chunk.VAO);
-        glDrawArrays(GL_TRIANGLES, 0,
-                     static_cast<GLsizei>(chunk.vertices.size()));
+        }
+
+        std::size_t firstQuad = mesh.faceFirstQuad[face];
+        std::size_t quads = 0;
+        while (face < FACE_COUNT && (faceMask & (1u << face)))
+            quads += mesh.faceQuadCount[face++];
+        if (quads == 0)
+            continue;
+
+        backend->draw(chunk.meshHandle, firstQuad, quads);
+        stats.trianglesDrawn += static_cast<long long>(quads) * 2;
     }
 }
 
-void ChunkManager::clear()
+/**
+ * World space bounds of a chunk's mesh.
+ */
+static void chunkBox(const Chunk& chunk, glm::vec3& min, glm::vec3& max)
+{
+    min = glm::vec3(chunk.coord.x * CHUNK_SIZE, chunk.mesh.minY,
+                    chunk.coord.y * CHUNK_SIZE);
+    max = glm::vec3(min.x + CHUNK_SIZE, chunk.mesh.maxY, min.z + CHUNK_SIZE);
+}
+
+void ChunkManager::addBounds(int slot)
 {
+    Chunk& chunk = world.at(slot);
+    if (chunk.meshHandle == -1)
+        return; // no faces, nothing to cull or draw
+    glm::vec3 min, max;
+    chunkBox(chunk, min, max);
+    chunk.boundsIndex = chunkBounds.add(min, max);
+    boundsOwners.push_back(slot);
+}
+
+void ChunkManager::removeBounds(Chunk& chunk)
+{
+    int index = chunk.boundsIndex;
+    chunkBounds.swapRemove(index);
+    boundsOwners[index] = boundsOwners.back();
+    boundsOwners.pop_back();
+    if (index < static_cast<int>(boundsOwners.size()))
+        world.at(boundsOwners[index]).boundsIndex = index;
+    chunk.boundsIndex = -1;
+}
+
+/**
+ * Refills the culling list after chunks moved to other grid slots.
+ */
+void ChunkManager::rebuildBounds()
+{
+    chunkBounds.clear();
+    boundsOwners.clear();
+    world.forEach(
+        [&](int slot, Chunk& chunk)
+        {
+            if (chunk.ready)
+                addBounds(slot);
+        });
+}
+
+/**
+ * Face directions of a chunk that can face a camera at cameraPos. Faces of a
+ * direction lie on planes inside the chunk bounds, so e.g. no +x face can be
+ * seen once the camera is at or behind the chunk's minimum x.
+ */
+static unsigned int cameraFaceMask(const Chunk& chunk, const glm::vec3& cameraPos)
+{
+    glm::vec3 min, max;
+    chunkBox(chunk, min, max);
+
+    unsigned int mask = 0;
+    if (cameraPos.x > min.x) mask |= 1u << FACE_POS_X;
+    if (cameraPos.x < max.x) mask |= 1u << FACE_NEG_X;
+    if (cameraPos.y > min.y) mask |= 1u << FACE_POS_Y;
+    if (cameraPos.y < max.y) mask |= 1u << FACE_NEG_Y;
+    if (cameraPos.z > min.z) mask |= 1u << FACE_POS_Z;
+    if (cameraPos.z < max.z) mask |= 1u << FACE_NEG_Z;
+    return mask;
+}
+
+/**
+ * Face directions lit by a directional light, the same for every chunk.
+ */
+static unsigned int lightFaceMask(const glm::vec3& lightDir)
+{
+    unsigned int mask = 0;
+    if (lightDir.x > 0.0f) mask |= 1u << FACE_POS_X;
+    if (lightDir.x < 0.0f) mask |= 1u << FACE_NEG_X;
+    if (lightDir.y > 0.0f) mask |= 1u << FACE_POS_Y;
+    if (lightDir.y < 0.0f) mask |= 1u << FACE_NEG_Y;
+    if (lightDir.z > 0.0f) mask |= 1u << FACE_POS_Z;
+    if (lightDir.z < 0.0f) mask |= 1u << FACE_NEG_Z;
+    return mask;
+}
+
+void ChunkManager::render(const Shader& shader, const glm::mat4& viewProjection,
+                          const glm::vec3& cameraPos)
+{
+    terrainStats = PassStats();
+    backend->beginPass(shader);
+    collectVisible(viewProjection, terrainStats);
+
+    std::chrono::steady_clock::time_point drawnAt = std::chrono::steady_clock::now();
+    for (int slot : drawList)
     {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        while (!generationQueue.empty())
-            generationQueue.pop();
+        Chunk& chunk = world.at(slot);
+        drawChunk(chunk, cameraFaceMask(chunk, cameraPos), terrainStats);
+        if (!chunk.drawn)
+        {
+            chunk.drawn = true;
+            recordLatency(PipelineStage::DrawWait, chunk.times.uploaded, drawnAt);
+            recordLatency(PipelineStage::Visible, chunk.times.requested, drawnAt);
+        }
     }
+    SubmitStats submitted = backend->endPass();
+    terrainStats.drawCalls = submitted.drawCalls;
+    terrainStats.drawRanges = submitted.drawRanges;
+}
+
+/**
+ * Only the faces turned towards the light can be the closest surface to it,
+ * so skipping the others leaves the depth map of the closed terrain
+ * unchanged. Chunks outside the light's box are clipped away by the
+ * rasterizer anyway and are culled up front.
+ */
+void ChunkManager::renderShadow(const Shader& shader,
+                                const glm::mat4& lightSpaceMatrix,
+                                const glm::vec3& lightDir)
+{
+    shadowStats = PassStats();
+    backend->beginPass(shader);
+    unsigned int faceMask = lightFaceMask(lightDir);
+    collectVisible(lightSpaceMatrix, shadowStats);
+
+    for (int slot : drawList)
+        drawChunk(world.at(slot), faceMask, shadowStats);
+    SubmitStats submitted = backend->endPass();
+    shadowStats.drawCalls = submitted.drawCalls;
+    shadowStats.drawRanges = submitted.drawRanges;
+}
+
+void ChunkManager::clear()
+{
+    cancelledJobs += workers.clear();
     {
         std::lock_guard<std::mutex> lock(uploadMutex);
         while (!uploadQueue.empty())
-            uploadQueue.pop();
-    }
-    for (auto& [key, chunk] : world)
-    {
-        if (chunk.ready)
         {
-            glDeleteVertexArrays(1, &chunk.VAO);
-            glDeleteBuffers(1, &chunk.VBO);
+            dropResult(uploadQueue.front());
+            uploadQueue.pop();
         }
     }
+    for (const GenerationResult& result : pendingUploads)
+        dropResult(result);
+    pendingUploads.clear();
+    pendingUploadBytes = 0;
+    uploadStats.latencyMaxMs = 0.0f;
+    world.forEach([&](int, Chunk& chunk) { unload(chunk); });
     world.clear();
-}
\ No newline at end of file
+    evictedChunks.clear();
+    hasPlayerChunk = false;
+    loadedRadius = -1;
+}
+
+void ChunkManager::shutdown()
+{
+    // no worker may be writing to staging memory the backend frees
+    cancelledJobs += workers.shutdown();
+    clear();
+    // later calls, including the destructor's, must not touch the GPU
+    backend = std::make_unique<NullBackend>();
+    backend->setVertexFormat(vertexFormat);
+}
+
+int ChunkManager::getWorkerCount() const
+{
+    return workers.size();
+}
+
+/**
+ * @brief Resizes the generation pool. Requests still queued are kept and
+ * redistributed over the new workers.
+ */
+void ChunkManager::setWorkerCount(int count)
+{
+    workers.resize(count);
+}
+
+int ChunkManager::getPendingGenerations() const
+{
+    return workers.pendingCount();
+}
+
+float ChunkManager::getFirstRingTime() const
+{
+    return firstRingTime;
+}
+
+long long ChunkManager::getResidentTriangles() const
+{
+    return residentVertices / QUAD_VERTICES * 2;
+}
+
+VertexFormat ChunkManager::getVertexFormat() const
+{
+    return vertexFormat;
+}
+
+void ChunkManager::setVertexFormat(VertexFormat format)
+{
+    if (format == vertexFormat)
+        return;
+    vertexFormat = format;
+    clear();
+    backend->setVertexFormat(format);
+}
+
+MeshMemory ChunkManager::getMeshMemory() const
+{
+    MeshMemory memory;
+    memory.format = vertexFormat;
+    memory.vertices = residentVertices;
+    memory.queuedBytes = pendingUploadBytes;
+    memory.compressedBytes = compressedBytes;
+    memory.gpuBytes = gpuMeshBytes;
+    BackendStats gpu = backend->getStats();
+    memory.arenaBytes = gpu.arena.capacityBytes;
+    memory.stagingBytes = gpu.staging.capacityBytes;
+    memory.indexBytes = gpu.indexBytes;
+    memory.floatLayoutBytes = residentVertices * sizeof(Vertex);
+    memory.packedLayoutBytes = residentVertices * sizeof(PackedVertex);
+    return memory;
+}
+
+void ChunkManager::setCompressedCopies(bool enabled)
+{
+    compressedCopies = enabled;
+}
+
+bool ChunkManager::getCompressedCopies() const
+{
+    return compressedCopies;
+}
+
+PassStats ChunkManager::getTerrainStats() const
+{
+    return terrainStats;
+}
+
+PassStats ChunkManager::getShadowStats() const
+{
+    return shadowStats;
+}
+
+ArenaStats ChunkManager::getArenaStats() const
+{
+    return backend->getStats().arena;
+}
+
+CacheStats ChunkManager::getCacheStats() const
+{
+    CacheStats stats;
+    stats.entries = static_cast<int>(evictedChunks.size());
+    stats.capacity = static_cast<int>(evictedChunks.capacity());
+    stats.hits = cacheHits;
+    stats.misses = cacheMisses;
+    stats.reuploads = cacheReuploads;
+    return stats;
+}
+
+StagingStats ChunkManager::getStagingStats() const
+{
+    return backend->getStats().staging;
+}
+
+UploadStats ChunkManager::getUploadStats() const
+{
+    return uploadStats;
+}
+
+GenerationCounters ChunkManager::getGenerationCounters() const
+{
+    GenerationCounters counters;
+    counters.requested = requestedJobs;
+    counters.completed = completedJobs.load();
+    counters.cancelled = cancelledJobs.load();
+    counters.abandoned = abandonedJobs.load();
+    counters.stale = staleResults;
+    return counters;
+}
+
+PipelineCounters ChunkManager::getPipelineCounters() const
+{
+    PipelineCounters counters;
+    counters.queued = workers.pendingCount();
+    counters.inFlight = generatingJobs.load();
+    {
+        std::lock_guard<std::mutex> lock(uploadMutex);
+        counters.awaitingUpload = static_cast<int>(uploadQueue.size());
+    }
+    counters.awaitingUpload += static_cast<int>(pendingUploads.size());
+    counters.resident = residentChunks;
+    counters.evicted = evictions;
+    counters.workerUtilization = workerUtilization;
+    return counters;
+}
+
+const LatencyHistogram& ChunkManager::getStageLatency(PipelineStage stage) const
+{
+    return stageLatency[static_cast<int>(stage)];
+}
+
+void ChunkManager::resetStageLatency()
+{
+    for (LatencyHistogram& histogram : stageLatency)
+        histogram.clear();
+}
+
+void ChunkManager::recordLatency(PipelineStage stage,
+                                 std::chrono::steady_clock::time_point from,
+                                 std::chrono::steady_clock::time_point to)
+{
+    if (from == std::chrono::steady_clock::time_point())
+        return; // the chunk never passed the start of this stage
+    stageLatency[static_cast<int>(stage)].record(
+        std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+/**
+ * Turns the generation time the workers reported into a utilization once a
+ * window has passed. Jobs are counted when they end, so a window can be
+ * credited with work done in the previous one, which the clamp hides.
+ */
+void ChunkManager::sampleUtilization()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::nanoseconds elapsed = now - utilizationStart;
+    if (elapsed < UTILIZATION_WINDOW)
+        return;
+
+    long long busy = workerBusyNs.load();
+    double capacity = static_cast<double>(elapsed.count()) * std::max(workers.size(), 1);
+    workerUtilization = static_cast<float>(
+        std::min((busy - utilizationBusyStart) / capacity, 1.0));
+    utilizationStart = now;
+    utilizationBusyStart = busy;
+}
+
+void ChunkManager::writePipelineReport(std::ostream& out) const
+{
+    PipelineCounters counters = getPipelineCounters();
+    out << "{\n";
+    out << "  \"workers\": " << workers.size() << ",\n";
+    out << "  \"worker_utilization\": " << counters.workerUtilization << ",\n";
+    out << "  \"queued\": " << counters.queued << ",\n";
+    out << "  \"in_flight\": " << counters.inFlight << ",\n";
+    out << "  \"awaiting_upload\": " << counters.awaitingUpload << ",\n";
+    out << "  \"resident\": " << counters.resident << ",\n";
+    out << "  \"evicted\": " << counters.evicted << ",\n";
+    out << "  \"stages\": [\n";
+    for (int i = 0; i < PIPELINE_STAGE_COUNT; ++i)
+    {
+        const LatencyHistogram& histogram = stageLatency[i];
+        out << "    {\"name\": \"" << pipelineStageName(static_cast<PipelineStage>(i))
+            << "\", \"count\": " << histogram.count()
+            << ", \"mean_ms\": " << histogram.mean() * 1e-3
+            << ", \"p50_ms\": " << histogram.percentile(50.0) * 1e-3
+            << ", \"p90_ms\": " << histogram.percentile(90.0) * 1e-3
+            << ", \"p99_ms\": " << histogram.percentile(99.0) * 1e-3
+            << ", \"max_ms\": " << histogram.max() * 1e-3 << "}"
+            << (i + 1 < PIPELINE_STAGE_COUNT ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
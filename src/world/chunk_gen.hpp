@@ -1,61 +1,484 @@
 #pragma once
 
-#include <unordered_map>
 #include <vector>
 #include <glm/glm.hpp>
 #include "../noise/perlin_gen.hpp"
+#include "../render/frustum.hpp"
+#include "chunk_backend.hpp"
+#include "latency_histogram.hpp"
+#include "lru_cache.hpp"
+#include "toroidal_grid.hpp"
+#include "worker_pool.hpp"
 
-#include <thread>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <ostream>
 #include <queue>
-#include <atomic>
-#include <condition_variable>
+
+class Shader;
+
+/**
+ * @brief Shared flag set by the render thread once a chunk leaves range, so
+ * workers can skip or abandon its generation.
+ */
+using CancelToken = std::shared_ptr<std::atomic<bool>>;
+
+/**
+ * @brief When a chunk passed each point of the pipeline, carried from its
+ * request to the result to the chunk. Points not reached yet are default
+ * constructed.
+ */
+struct ChunkTimestamps {
+    /** Entered the load square in update() */
+    std::chrono::steady_clock::time_point requested;
+    /** Picked up by a worker */
+    std::chrono::steady_clock::time_point generationStarted;
+    /** Mesh built, staged and queued for upload */
+    std::chrono::steady_clock::time_point generated;
+    std::chrono::steady_clock::time_point uploadStarted;
+    std::chrono::steady_clock::time_point uploaded;
+};
+
+/**
+ * @brief Spans of a chunk's way from request to screen, each with a
+ * LatencyHistogram in ChunkManager.
+ */
+enum class PipelineStage {
+    /** requested to generationStarted */
+    QueueWait,
+    /** generationStarted to generated */
+    Generation,
+    /** generated to uploadStarted */
+    UploadWait,
+    /** uploadStarted to uploaded */
+    Upload,
+    /** uploaded to the first terrain pass drawing the chunk */
+    DrawWait,
+    /** requested to uploaded */
+    Ready,
+    /** requested to the first terrain pass drawing the chunk */
+    Visible,
+    Count
+};
+
+inline constexpr int PIPELINE_STAGE_COUNT = static_cast<int>(PipelineStage::Count);
+
+/**
+ * @return snake_case name of a stage, as used in reports.
+ */
+const char* pipelineStageName(PipelineStage stage);
+
+/**
+ * @brief Chunks at each point of the pipeline right now.
+ */
+struct PipelineCounters {
+    /** Requests waiting for a worker. */
+    int queued = 0;
+    /** Being generated. */
+    int inFlight = 0;
+    /** Generated or restored meshes waiting for upload. */
+    int awaitingUpload = 0;
+    /** Chunks with a mesh on the GPU, cached ones included. */
+    int resident = 0;
+    /** Chunks evicted from the world since the start. */
+    long long evicted = 0;
+    /**
+     * @brief Share of the workers' time spent generating over the last
+     * utilization window, 0 to 1.
+     */
+    float workerUtilization = 0.0f;
+};
 
 struct GenerationRequest {
     int x, z;
     long long key;
+    /**
+     * @brief Load generation of the chunk this request was made for. Results
+     * from an earlier load of the same coordinate are rejected on upload.
+     */
+    unsigned int epoch = 0;
+    CancelToken cancelled;
+    VertexFormat format = VertexFormat::Float;
+    /** Also produce a compressed copy of the vertices. */
+    bool compress = false;
+    /**
+     * @brief Scheduling score, lower is generated first. Based on distance to
+     * the player and angle to the camera's view direction.
+     */
+    float priority = 0.0f;
+    ChunkTimestamps times;
 };
 
 struct GenerationResult {
+    int x, z;
     long long key;
-    std::vector<Vertex> vertices;
+    unsigned int epoch;
+    ChunkMesh mesh;
+    /** Copy of the mesh's vertices staged by the backend, if there was room */
+    StagingBlock staging;
+    std::vector<std::uint8_t> compressed;
+    /**
+     * @brief The vertices are to be restored from the chunk's compressed copy
+     * instead of coming with the result.
+     */
+    bool restore = false;
+    ChunkTimestamps times;
+};
+
+/**
+ * Frame time the upload budget adapts to, and the overshoot tolerated before
+ * the budget is cut.
+ */
+inline constexpr float TARGET_FRAME_TIME = 1.0f / 60.0f;
+inline constexpr float FRAME_TIME_TOLERANCE = 1.2f;
+
+/**
+ * Bounds and growth of the per-frame upload time budget, in milliseconds.
+ */
+inline constexpr float MIN_UPLOAD_BUDGET_MS = 0.5f;
+inline constexpr float MAX_UPLOAD_BUDGET_MS = 8.0f;
+inline constexpr float INITIAL_UPLOAD_BUDGET_MS = 2.0f;
+inline constexpr float UPLOAD_BUDGET_STEP_MS = 0.25f;
+
+/**
+ * Caps the vertex data handed to the driver in one frame, whatever the time
+ * budget, since buffer updates are mostly paid for later by the driver.
+ */
+inline constexpr std::size_t MAX_UPLOAD_BYTES_PER_FRAME = 8 * 1024 * 1024;
+
+/**
+ * @brief Snapshot of the mesh upload scheduler.
+ */
+struct UploadStats {
+    /** Generated meshes waiting for upload. */
+    int backlog = 0;
+    std::size_t backlogBytes = 0;
+    /** Upload time allowed per frame, adapted to the measured frame time. */
+    float budgetMs = 0.0f;
+    int uploadsLastFrame = 0;
+    std::size_t bytesLastFrame = 0;
+    float uploadMsLastFrame = 0.0f;
+    /** Time from a mesh being generated to its upload. */
+    float latencyAvgMs = 0.0f;
+    /** Worst latency since the world was last cleared. */
+    float latencyMaxMs = 0.0f;
+};
+
+/**
+ * @brief Snapshot of how generation jobs ended.
+ */
+struct GenerationCounters {
+    /** Jobs submitted to the workers. */
+    int requested = 0;
+    /** Finished and queued for upload. */
+    int completed = 0;
+    /** Skipped before any work started. */
+    int cancelled = 0;
+    /** Dropped part way through generation. */
+    int abandoned = 0;
+    /** Finished, but the chunk was unloaded or reloaded before upload. */
+    int stale = 0;
+};
+
+/**
+ * @brief Bytes held by chunk meshes, with the size the same vertices would
+ * take in either layout for comparison.
+ */
+struct MeshMemory {
+    VertexFormat format = VertexFormat::Float;
+    long long vertices = 0;
+    /** Uncompressed meshes waiting for upload, the only full CPU copies. */
+    std::size_t queuedBytes = 0;
+    /** Compressed copies kept for re-upload. */
+    std::size_t compressedBytes = 0;
+    /** Vertex data of uploaded chunks on the GPU. */
+    std::size_t gpuBytes = 0;
+    /** Arena pages, used or not. */
+    std::size_t arenaBytes = 0;
+    std::size_t stagingBytes = 0;
+    /** Index buffer shared by every chunk. */
+    std::size_t indexBytes = 0;
+    std::size_t floatLayoutBytes = 0;
+    std::size_t packedLayoutBytes = 0;
+};
+
+/**
+ * @brief State of the cache of chunks evicted from the world.
+ */
+struct CacheStats {
+    int entries = 0;
+    int capacity = 0;
+    /** Chunks entering range that were restored from the cache. */
+    long long hits = 0;
+    /** Hits re-uploaded from a compressed copy. */
+    long long reuploads = 0;
+    /** Chunks entering range that had to be generated. */
+    long long misses = 0;
+};
+
+/**
+ * @brief Draw statistics of one render pass over the last frame.
+ */
+struct PassStats {
+    int chunksDrawn = 0;
+    /** Ready chunks outside the pass's view or light volume. */
+    int chunksCulled = 0;
+    /** Draw calls issued, one per backend batch group with visible chunks. */
+    int drawCalls = 0;
+    /** Index ranges submitted through those calls. */
+    int drawRanges = 0;
+    long long trianglesDrawn = 0;
+    /** Triangles in face direction buckets pointing away from the viewer. */
+    long long trianglesSkipped = 0;
 };
 
 /**
  * @struct Chunk
  * @brief Represents a single voxel block chunk in the world
  * 
- * Each chunk has a 2D coordinate, a vertex buffer for rendering, and OpenGL calls.
+ * Each chunk has a 2D coordinate and a handle to its mesh in the backend.
  */
 struct Chunk {
     glm::vec2 coord;
-    std::vector<Vertex>vertices;
-    unsigned int VBO, VAO;
+    /**
+     * @brief Face ranges and height bounds of the mesh. Its vertices are
+     * released once uploaded.
+     */
+    ChunkMesh mesh;
+    /** Vertices of the mesh, kept after the CPU copy is released. */
+    std::uint32_t vertexCount = 0;
+    /** Compressed vertices, only kept while compressed copies are enabled. */
+    std::vector<std::uint8_t> compressed;
+    unsigned int epoch = 0;
+    CancelToken cancelled;
+    /**
+     * @brief Handle of the uploaded mesh in ChunkManager's backend, -1 while
+     * not uploaded and for ready chunks without faces.
+     */
+    int meshHandle = -1;
+    /**
+     * @brief Slot of the chunk's box in ChunkManager's culling list, -1
+     * while not uploaded.
+     */
+    int boundsIndex = -1;
     /**
      * @brief Becomes true after mesh generation and buffer uploads.
      */
     bool ready = false;
+    ChunkTimestamps times;
+    /** Drawn by a terrain pass since its upload, which ends its measurement */
+    bool drawn = false;
 };
 
 
 class ChunkManager {
     private:
-        std::unordered_map<long long, Chunk> world;
+        /**
+         * @brief Loaded chunks, in a square grid wrapping around at
+         * 2 * evict radius + 1 chunks.
+         */
+        ToroidalGrid<Chunk> world;
+
+        /**
+         * @brief Uploaded chunks that left the evict radius, keyed by chunk
+         * key. They keep their GPU range, so coming back into range costs no
+         * generation or upload. With compressed copies enabled they keep the
+         * compressed copy instead and are re-uploaded from it.
+         */
+        LruCache<long long, Chunk> evictedChunks;
+        long long cacheHits = 0;
+        long long cacheMisses = 0;
+        long long cacheReuploads = 0;
 
-        std::queue<GenerationRequest> generationQueue;
         std::queue<GenerationResult> uploadQueue;
-        std::mutex queueMutex;
-        std::mutex uploadMutex;
-        std::atomic<bool> running{true};
-        std::thread workerThread;
-        std::condition_variable cv;
+        mutable std::mutex uploadMutex;
+
+        /**
+         * @brief Results taken off uploadQueue, uploaded oldest first as the
+         * frame budget allows. Only touched by the render thread.
+         */
+        std::deque<GenerationResult> pendingUploads;
+        std::size_t pendingUploadBytes = 0;
+        /* Results whose staging segment is not readable yet, retried next frame */
+        std::vector<GenerationResult> deferredUploads;
+        float uploadBudgetMs;
+        UploadStats uploadStats;
+
+        unsigned int nextEpoch = 1;
+
+        int requestedJobs = 0;
+        std::atomic<int> completedJobs{0};
+        std::atomic<int> cancelledJobs{0};
+        std::atomic<int> abandonedJobs{0};
+        int staleResults = 0;
+
+        /* Latency of each PipelineStage, recorded on the render thread */
+        std::array<LatencyHistogram, PIPELINE_STAGE_COUNT> stageLatency;
+        std::atomic<int> generatingJobs{0};
+        /* Generation time summed over every worker, for the utilization */
+        std::atomic<long long> workerBusyNs{0};
+        std::chrono::steady_clock::time_point utilizationStart;
+        long long utilizationBusyStart = 0;
+        float workerUtilization = 0.0f;
+        int residentChunks = 0;
+        long long evictions = 0;
+
+        void recordLatency(PipelineStage stage, std::chrono::steady_clock::time_point from,
+                           std::chrono::steady_clock::time_point to);
+        void sampleUtilization();
+
+        VertexFormat vertexFormat = VertexFormat::Packed;
+
+        bool compressedCopies = false;
+
+        /* Vertices of every uploaded chunk */
+        long long residentVertices = 0;
+        std::size_t gpuMeshBytes = 0;
+        std::size_t compressedBytes = 0;
+
+        /**
+         * @brief GPU side: keeps uploaded meshes and submits draws.
+         */
+        std::unique_ptr<ChunkBackend> backend;
+
+        PassStats terrainStats;
+        PassStats shadowStats;
+
+        /**
+         * @brief World space boxes of every uploaded chunk for frustum culling,
+         * boundsOwners[i] is the world slot of the chunk of box i.
+         */
+        BoxList chunkBounds;
+        std::vector<int> boundsOwners;
+        std::vector<unsigned char> chunkVisible;
+        /* Slots of the chunks to draw in the current pass, sorted by batch group */
+        std::vector<int> drawList;
+
+        void addBounds(int slot);
+        void removeBounds(Chunk& chunk);
+        void rebuildBounds();
+
+        void uploadChunk(int slot, const StagingBlock& staging);
+        void dropResult(const GenerationResult& result);
+        void unload(Chunk& chunk);
+        void releaseGpuMesh(Chunk& chunk);
+        void queueReupload(int slot);
+        void evict(int slot);
+        void collectVisible(const glm::mat4& viewProjection, PassStats& stats);
+        void drawChunk(const Chunk& chunk, unsigned int faceMask, PassStats& stats);
+
+        /* Player chunk seen by the last update(), used to detect crossings */
+        int lastPlayerChunk_x = 0;
+        int lastPlayerChunk_z = 0;
+        bool hasPlayerChunk = false;
+        /* Load radius of the last update(), -1 when the world is empty */
+        int loadedRadius = -1;
+
+        /* Time-to-first-visible-ring measurement */
+        std::vector<glm::ivec2> firstRingChunks;
+        std::chrono::steady_clock::time_point firstRingStart;
+        bool firstRingPending = false;
+        float firstRingTime = 0.0f;
+
+        void startFirstRingTimer(int playerChunk_x, int playerChunk_z,
+                                 const glm::vec3& viewDir);
+        void checkFirstRingTimer();
+
+        /**
+         * @brief Generation workers. Declared last so the threads are joined
+         * before the upload queue they write into is destroyed.
+         */
+        WorkerPool<GenerationRequest> workers;
+
+        void generate(GenerationRequest& req);
 
     public:
-        ChunkManager();
+        /**
+         * @param backend GPU side of the chunk pipeline, GlChunkBackend for the
+         * game or NullBackend to run without a graphics context.
+         */
+        explicit ChunkManager(std::unique_ptr<ChunkBackend> backend);
         ~ChunkManager();
 
-        void update(const int playerChunk_x, const int playerChunk_z, const int render_distance);
-        void uploadMesh();
-        void render();
+        void update(const int playerChunk_x, const int playerChunk_z, const int render_distance,
+                    const glm::vec3& viewDir);
+        /**
+         * @brief Uploads pending meshes within a time budget adapted to the
+         * duration of the previous frame.
+         * @param frameTime Duration of the previous frame in seconds.
+         */
+        void uploadMesh(float frameTime);
+        /**
+         * @brief Draws the ready chunks inside the camera frustum, skipping the
+         * face directions of each chunk that point away from it. The shader
+         * must already be in use.
+         * @param viewProjection Camera projection * view, used for culling.
+         */
+        void render(const Shader& shader, const glm::mat4& viewProjection,
+                    const glm::vec3& cameraPos);
+        /**
+         * @brief Draws the ready chunks inside a directional light's volume
+         * into its depth map, skipping face directions that point away from
+         * the light.
+         * @param lightSpaceMatrix Light projection * view, used for culling.
+         * @param lightDir Direction towards the light.
+         */
+        void renderShadow(const Shader& shader, const glm::mat4& lightSpaceMatrix,
+                          const glm::vec3& lightDir);
         void clear();
+        /**
+         * @brief Joins the workers, unloads every chunk and destroys the
+         * backend, which must happen while its GPU context is current.
+         * Chunks are no longer generated afterwards.
+         */
+        void shutdown();
+
+        int getWorkerCount() const;
+        void setWorkerCount(int count);
+        int getPendingGenerations() const;
+        /**
+         * @return Milliseconds it took for the chunks around and in front of
+         * the player to become visible after the last chunk crossing.
+         */
+        float getFirstRingTime() const;
+        GenerationCounters getGenerationCounters() const;
+        PipelineCounters getPipelineCounters() const;
+        const LatencyHistogram& getStageLatency(PipelineStage stage) const;
+        /**
+         * @brief Forgets every recorded latency, e.g. after warming up.
+         */
+        void resetStageLatency();
+        /**
+         * @brief Writes the counters and each stage's count, mean, p50, p90,
+         * p99 and max in milliseconds as JSON.
+         */
+        void writePipelineReport(std::ostream& out) const;
+        UploadStats getUploadStats() const;
+        StagingStats getStagingStats() const;
+        /**
+         * @return Triangles across every chunk currently uploaded.
+         */
+        long long getResidentTriangles() const;
+
+        VertexFormat getVertexFormat() const;
+        /**
+         * @brief Switches the vertex layout, regenerating the whole world.
+         */
+        void setVertexFormat(VertexFormat format);
+        MeshMemory getMeshMemory() const;
+        /**
+         * @brief Keeps a compressed CPU copy of newly generated meshes. Chunks
+         * moving into the cache then give up their GPU range and are
+         * re-uploaded from the copy when they return.
+         */
+        void setCompressedCopies(bool enabled);
+        bool getCompressedCopies() const;
+        CacheStats getCacheStats() const;
+        ArenaStats getArenaStats() const;
+        PassStats getTerrainStats() const;
+        PassStats getShadowStats() const;
 };
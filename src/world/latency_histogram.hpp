@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @class LatencyHistogram
+ * @brief Fixed size log-linear histogram of durations in microseconds, in the
+ * style of HdrHistogram.
+ *
+ * Values below 2 * SUB_BUCKETS_HALF land in buckets of their own. Above, each
+ * power of two is split into SUB_BUCKETS_HALF equal buckets, so any recorded
+ * value is known to within 1 / SUB_BUCKETS_HALF (about 3%) of itself, from a
+ * microsecond up to MAX_MICROSECONDS (about 18 minutes), in a few kilobytes
+ * and without allocating. Larger values are clamped.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr int SUB_BUCKET_BITS = 6;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int SUB_BUCKETS_HALF = SUB_BUCKETS / 2;
+    static constexpr int MAX_MAGNITUDE = 30;
+    static constexpr std::int64_t MAX_MICROSECONDS = (std::int64_t(1) << MAX_MAGNITUDE) - 1;
+    static constexpr int BUCKETS =
+        SUB_BUCKETS + (MAX_MAGNITUDE - SUB_BUCKET_BITS) * SUB_BUCKETS_HALF;
+
+    void record(std::int64_t microseconds)
+    {
+        std::int64_t value = std::clamp<std::int64_t>(microseconds, 0, MAX_MICROSECONDS);
+        counts[bucketOf(value)]++;
+        total++;
+        sum += value;
+        maxValue = std::max(maxValue, value);
+    }
+
+    void clear()
+    {
+        counts.fill(0);
+        total = 0;
+        sum = 0;
+        maxValue = 0;
+    }
+
+    long long count() const { return total; }
+    std::int64_t max() const { return maxValue; }
+    double mean() const { return total > 0 ? static_cast<double>(sum) / total : 0.0; }
+
+    /**
+     * @return Highest value sharing a bucket with the value at percentile p
+     * (0-100) by nearest rank, so never below the true value. 0 when empty.
+     */
+    std::int64_t percentile(double p) const
+    {
+        if (total == 0)
+            return 0;
+        long long rank = static_cast<long long>(std::ceil(p / 100.0 * total));
+        rank = std::clamp<long long>(rank, 1, total);
+
+        long long seen = 0;
+        for (int i = 0; i < BUCKETS; ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+                return std::min(highestInBucket(i), maxValue);
+        }
+        return maxValue;
+    }
+
+private:
+    static int magnitude(std::int64_t value)
+    {
+        int bits = 0;
+        while (value >> (bits + 1))
+            bits++;
+        return bits;
+    }
+
+    static int bucketOf(std::int64_t value)
+    {
+        if (value < SUB_BUCKETS)
+            return static_cast<int>(value);
+        // keep the top SUB_BUCKET_BITS bits, the lower ones set the bucket width
+        int shift = magnitude(value) - (SUB_BUCKET_BITS - 1);
+        int top = static_cast<int>(value >> shift);
+        return SUB_BUCKETS + (shift - 1) * SUB_BUCKETS_HALF + (top - SUB_BUCKETS_HALF);
+    }
+
+    static std::int64_t highestInBucket(int bucket)
+    {
+        if (bucket < SUB_BUCKETS)
+            return bucket;
+        int shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS_HALF + 1;
+        std::int64_t top = (bucket - SUB_BUCKETS) % SUB_BUCKETS_HALF + SUB_BUCKETS_HALF;
+        return ((top + 1) << shift) - 1;
+    }
+
+    std::array<long long, BUCKETS> counts{};
+    long long total = 0;
+    std::int64_t sum = 0;
+    std::int64_t maxValue = 0;
+};
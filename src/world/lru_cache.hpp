@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @class LruCache
+ * @brief Bounded key-value store that drops its least recently inserted
+ * entries first.
+ *
+ * Entries are taken out on lookup rather than copied, which suits values
+ * owning resources such as GPU buffers. Values pushed out by the capacity
+ * limit, or dropped by clear(), are handed to the eviction callback so their
+ * resources can be released.
+ */
+template <typename Key, typename Value>
+class LruCache
+{
+public:
+    using EvictFn = std::function<void(Value&)>;
+
+    LruCache(std::size_t capacity, EvictFn onEvict)
+        : maxEntries(capacity), onEvict(std::move(onEvict))
+    {
+    }
+
+    /**
+     * @brief Stores a value as the most recent entry, replacing any value
+     * already cached for the key.
+     */
+    void put(const Key& key, Value value)
+    {
+        auto found = index.find(key);
+        if (found != index.end())
+        {
+            onEvict(found->second->second);
+            entries.erase(found->second);
+            index.erase(found);
+        }
+
+        entries.emplace_front(key, std::move(value));
+        index[key] = entries.begin();
+        trim();
+    }
+
+    /**
+     * @brief Removes and returns the value cached for a key, if any.
+     */
+    std::optional<Value> take(const Key& key)
+    {
+        auto found = index.find(key);
+        if (found == index.end())
+            return std::nullopt;
+
+        Value value = std::move(found->second->second);
+        entries.erase(found->second);
+        index.erase(found);
+        return value;
+    }
+
+    void clear()
+    {
+        for (auto& entry : entries)
+            onEvict(entry.second);
+        entries.clear();
+        index.clear();
+    }
+
+    void setCapacity(std::size_t capacity)
+    {
+        maxEntries = capacity;
+        trim();
+    }
+
+    std::size_t size() const { return entries.size(); }
+    std::size_t capacity() const { return maxEntries; }
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    std::size_t maxEntries;
+    EvictFn onEvict;
+    /** Most recent entry first */
+    std::list<Entry> entries;
+    std::unordered_map<Key, typename std::list<Entry>::iterator> index;
+
+    void trim()
+    {
+        while (entries.size() > maxEntries)
+        {
+            onEvict(entries.back().second);
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+};
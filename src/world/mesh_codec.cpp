@@ -0,0 +1,79 @@
+#include "mesh_codec.hpp"
+
+/*
+Format
+
+A zero byte is followed by a run length of 1 to 255 zero differences, any
+other byte is a single nonzero difference. Differences are taken over the
+byte planes back to back, the first byte against zero.
+*/
+
+std::vector<std::uint8_t> compressVertices(const void* vertices, std::size_t count,
+                                           std::size_t stride)
+{
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(vertices);
+    std::size_t size = count * stride;
+
+    std::vector<std::uint8_t> planes(size);
+    for (std::size_t v = 0; v < count; ++v)
+    {
+        for (std::size_t b = 0; b < stride; ++b)
+            planes[b * count + v] = bytes[v * stride + b];
+    }
+
+    std::vector<std::uint8_t> out;
+    out.reserve(size / 2);
+    std::uint8_t previous = 0;
+    std::size_t i = 0;
+    while (i < size)
+    {
+        std::uint8_t difference = static_cast<std::uint8_t>(planes[i] - previous);
+        if (difference != 0)
+        {
+            out.push_back(difference);
+            previous = planes[i++];
+            continue;
+        }
+
+        std::size_t run = 0;
+        while (i < size && planes[i] == previous && run < 255)
+        {
+            ++run;
+            ++i;
+        }
+        out.push_back(0);
+        out.push_back(static_cast<std::uint8_t>(run));
+    }
+    out.shrink_to_fit();
+    return out;
+}
+
+void decompressVertices(const std::vector<std::uint8_t>& compressed, void* out,
+                        std::size_t count, std::size_t stride)
+{
+    std::size_t size = count * stride;
+    std::vector<std::uint8_t> planes(size);
+
+    std::uint8_t previous = 0;
+    std::size_t i = 0;
+    for (std::size_t c = 0; c < compressed.size() && i < size; ++c)
+    {
+        if (compressed[c] != 0)
+        {
+            previous = static_cast<std::uint8_t>(previous + compressed[c]);
+            planes[i++] = previous;
+            continue;
+        }
+
+        std::size_t run = compressed[++c];
+        for (std::size_t r = 0; r < run && i < size; ++r)
+            planes[i++] = previous;
+    }
+
+    std::uint8_t* bytes = static_cast<std::uint8_t*>(out);
+    for (std::size_t v = 0; v < count; ++v)
+    {
+        for (std::size_t b = 0; b < stride; ++b)
+            bytes[v * stride + b] = planes[b * count + v];
+    }
+}
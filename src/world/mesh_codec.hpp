@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Lossless compression of vertex arrays for meshes kept in system
+ * memory, tuned for decoding speed over ratio.
+ *
+ * Vertices are split into byte planes (byte 0 of every vertex, then byte 1,
+ * ...), each byte is stored as the difference to the previous one and runs of
+ * zero differences are collapsed. Neighboring vertices of a voxel mesh share
+ * most of their bytes, so the planes are mostly zero runs.
+ */
+std::vector<std::uint8_t> compressVertices(const void* vertices, std::size_t count,
+                                           std::size_t stride);
+
+/**
+ * @brief Restores count vertices of the given stride into out.
+ */
+void decompressVertices(const std::vector<std::uint8_t>& compressed, void* out,
+                        std::size_t count, std::size_t stride);
@@ -0,0 +1,71 @@
+#include "null_backend.hpp"
+
+#include <algorithm>
+
+void NullBackend::setVertexFormat(VertexFormat format)
+{
+    stride = format == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+}
+
+bool NullBackend::stage(const ChunkMesh& /*mesh*/, StagingBlock& /*block*/)
+{
+    return false;
+}
+
+int NullBackend::upload(const ChunkMesh& mesh, const StagingBlock& /*staging*/,
+                        const glm::ivec3& /*origin*/)
+{
+    int handle;
+    if (!freeHandles.empty())
+    {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    }
+    else
+    {
+        handle = static_cast<int>(meshBytes.size());
+        meshBytes.push_back(0);
+    }
+
+    meshBytes[handle] = mesh.vertexCount() * stride;
+    residentMeshes++;
+    residentBytes += meshBytes[handle];
+    maxQuads = std::max(maxQuads, mesh.quadCount());
+    return handle;
+}
+
+void NullBackend::release(int handle)
+{
+    residentMeshes--;
+    residentBytes -= meshBytes[handle];
+    meshBytes[handle] = 0;
+    freeHandles.push_back(handle);
+}
+
+void NullBackend::beginPass(const Shader& /*shader*/)
+{
+    pass = SubmitStats();
+}
+
+void NullBackend::draw(int /*handle*/, std::size_t /*firstQuad*/, std::size_t /*quads*/)
+{
+    pass.drawRanges++;
+}
+
+SubmitStats NullBackend::endPass()
+{
+    if (pass.drawRanges > 0)
+        pass.drawCalls = 1;
+    return pass;
+}
+
+BackendStats NullBackend::getStats() const
+{
+    BackendStats stats;
+    stats.arena.pages = residentMeshes > 0 ? 1 : 0;
+    stats.arena.allocations = residentMeshes;
+    stats.arena.capacityBytes = residentBytes;
+    stats.arena.usedBytes = residentBytes;
+    stats.indexBytes = maxQuads * QUAD_INDICES * sizeof(std::uint32_t);
+    return stats;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include "chunk_backend.hpp"
+
+/**
+ * @class NullBackend
+ * @brief ChunkBackend without a GPU. Uploads and draws only update the
+ * statistics, which report what a single arena page holding every resident
+ * mesh would contain.
+ *
+ * Lets ChunkManager stream chunks on servers and in benchmarks that have no
+ * graphics context. Nothing is staged, so workers never wait on upload memory.
+ */
+class NullBackend : public ChunkBackend {
+    public:
+        void setVertexFormat(VertexFormat format) override;
+
+        bool stage(const ChunkMesh& mesh, StagingBlock& block) override;
+        void beginUploads() override {}
+        bool isReadable(const StagingBlock& /*block*/) const override { return true; }
+        void dropStaged(const StagingBlock& /*block*/) override {}
+        int upload(const ChunkMesh& mesh, const StagingBlock& staging,
+                   const glm::ivec3& origin) override;
+        void release(int handle) override;
+        void endUploads() override {}
+
+        void beginPass(const Shader& shader) override;
+        int batchGroup(int /*handle*/) const override { return 0; }
+        int batchGroupCount() const override { return 1; }
+        void draw(int handle, std::size_t firstQuad, std::size_t quads) override;
+        SubmitStats endPass() override;
+
+        BackendStats getStats() const override;
+
+    private:
+        std::size_t stride = sizeof(PackedVertex);
+        /** Bytes of each handle's mesh, 0 for free handles */
+        std::vector<std::size_t> meshBytes;
+        std::vector<int> freeHandles;
+        int residentMeshes = 0;
+        std::size_t residentBytes = 0;
+        /** Largest mesh seen, in quads */
+        std::size_t maxQuads = 0;
+        SubmitStats pass;
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @class ToroidalGrid
+ * @brief Fixed-size square of cells addressed by 2D coordinates modulo the
+ * side length.
+ *
+ * Any side x side square of coordinates maps onto distinct cells, so a window
+ * of chunks centered on the player fits without collisions and wraps around
+ * as it moves: the cell freed by a chunk leaving one edge is the cell taken by
+ * the chunk entering at the opposite edge. Lookups are a modulo and a compare,
+ * and cells live in one contiguous array.
+ *
+ * @tparam T Cell value, default constructible and movable.
+ */
+template <typename T>
+class ToroidalGrid
+{
+public:
+    explicit ToroidalGrid(int side = 1) { allocate(side); }
+
+    int side() const { return gridSide; }
+    int capacity() const { return gridSide * gridSide; }
+    int count() const { return occupiedCount; }
+
+    /**
+     * @return Cell a coordinate maps to, whether occupied or not.
+     */
+    int slot(int x, int z) const
+    {
+        return wrap(x) * gridSide + wrap(z);
+    }
+
+    /**
+     * @return The value stored for a coordinate, nullptr if its cell is empty
+     * or holds another coordinate.
+     */
+    T* find(int x, int z)
+    {
+        int index = slot(x, z);
+        if (!occupied[index] || coords[index] != glm::ivec2(x, z))
+            return nullptr;
+        return &cells[index];
+    }
+
+    const T* find(int x, int z) const
+    {
+        return const_cast<ToroidalGrid*>(this)->find(x, z);
+    }
+
+    /**
+     * @brief Stores a fresh value for a coordinate. Its cell must be empty.
+     */
+    T& insert(int x, int z)
+    {
+        int index = slot(x, z);
+        assert(!occupied[index]);
+        occupied[index] = 1;
+        coords[index] = glm::ivec2(x, z);
+        occupiedCount++;
+        cells[index] = T();
+        return cells[index];
+    }
+
+    void erase(int index)
+    {
+        assert(occupied[index]);
+        occupied[index] = 0;
+        occupiedCount--;
+        cells[index] = T();
+    }
+
+    bool isOccupied(int index) const { return occupied[index] != 0; }
+    glm::ivec2 coord(int index) const { return coords[index]; }
+    T& at(int index) { return cells[index]; }
+    const T& at(int index) const { return cells[index]; }
+
+    /**
+     * @brief Calls fn(slot, value) for every occupied cell, in memory order.
+     */
+    template <typename Fn>
+    void forEach(Fn fn)
+    {
+        for (int index = 0; index < capacity(); ++index)
+        {
+            if (occupied[index])
+                fn(index, cells[index]);
+        }
+    }
+
+    /**
+     * @brief Changes the side length, moving every value to its new cell.
+     * Values must already fit, i.e. lie within one side x side square.
+     */
+    void resize(int side)
+    {
+        if (side == gridSide)
+            return;
+
+        std::vector<T> oldCells = std::move(cells);
+        std::vector<glm::ivec2> oldCoords = std::move(coords);
+        std::vector<unsigned char> oldOccupied = std::move(occupied);
+        allocate(side);
+
+        for (std::size_t index = 0; index < oldCells.size(); ++index)
+        {
+            if (!oldOccupied[index])
+                continue;
+            glm::ivec2 c = oldCoords[index];
+            insert(c.x, c.y) = std::move(oldCells[index]);
+        }
+    }
+
+    void clear()
+    {
+        allocate(gridSide);
+    }
+
+private:
+    int gridSide = 0;
+    int occupiedCount = 0;
+    std::vector<T> cells;
+    std::vector<glm::ivec2> coords;
+    std::vector<unsigned char> occupied;
+
+    int wrap(int value) const
+    {
+        int r = value % gridSide;
+        return r < 0 ? r + gridSide : r;
+    }
+
+    void allocate(int side)
+    {
+        gridSide = side;
+        occupiedCount = 0;
+        cells.clear();
+        cells.resize(capacity());
+        coords.assign(capacity(), glm::ivec2(0));
+        occupied.assign(capacity(), 0);
+    }
+};
+
+/**
+ * @brief Calls fn(x, z) for every chunk coordinate in the square of radius
+ * radiusA around a that lies outside the square of radius radiusB around b.
+ * A negative radiusB stands for an empty square. Columns of A are visited once
+ * each, so the work is O(radiusA) plus the size of the difference.
+ *
+ * Diffing the squares before and after a move finds the chunks leaving and
+ * entering a ToroidalGrid window without scanning it.
+ */
+template <typename Fn>
+void forEachOutside(glm::ivec2 a, int radiusA, glm::ivec2 b, int radiusB, Fn fn)
+{
+    int zMin = a.y - radiusA;
+    int zMax = a.y + radiusA;
+    for (int x = a.x - radiusA; x <= a.x + radiusA; ++x)
+    {
+        if (radiusB < 0 || std::abs(x - b.x) > radiusB)
+        {
+            for (int z = zMin; z <= zMax; ++z)
+                fn(x, z);
+            continue;
+        }
+        // only the parts of the column beyond b's z range
+        for (int z = zMin; z <= std::min(zMax, b.y - radiusB - 1); ++z)
+            fn(x, z);
+        for (int z = std::max(zMin, b.y + radiusB + 1); z <= zMax; ++z)
+            fn(x, z);
+    }
+}
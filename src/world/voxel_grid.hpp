@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Block ID stored per voxel. 0 is always air.
+ */
+using BlockID = std::uint8_t;
+
+/**
+ * @class VoxelGrid
+ * @brief Flat, fixed-size block storage for a single chunk.
+ *
+ * Blocks are laid out [x][z][y] with y innermost, matching the order terrain
+ * is generated and meshed in, so walking a column touches contiguous memory.
+ * The grid is surrounded by a border of Padding voxels on every side which
+ * lets neighbor lookups at x, z or y of -1 and Width, Length or Height go
+ * through without bounds checks. The border reads as air unless written.
+ */
+template <int Width, int Length, int Height, int Padding = 1>
+class VoxelGrid
+{
+public:
+    static constexpr int PADDED_WIDTH = Width + 2 * Padding;
+    static constexpr int PADDED_LENGTH = Length + 2 * Padding;
+    static constexpr int PADDED_HEIGHT = Height + 2 * Padding;
+    static constexpr int SIZE = PADDED_WIDTH * PADDED_LENGTH * PADDED_HEIGHT;
+
+    /**
+     * @brief Flat index of a voxel, valid for coordinates in
+     * [-Padding, Dimension + Padding).
+     */
+    static constexpr int index(int x, int z, int y)
+    {
+        return ((x + Padding) * PADDED_LENGTH + (z + Padding)) * PADDED_HEIGHT +
+               (y + Padding);
+    }
+
+    BlockID get(int x, int z, int y) const { return blocks[index(x, z, y)]; }
+    void set(int x, int z, int y, BlockID id) { blocks[index(x, z, y)] = id; }
+
+    /**
+     * @return Pointer to the block at y = 0 of a column, the rest of the
+     * column follows contiguously.
+     */
+    BlockID* column(int x, int z) { return &blocks[index(x, z, 0)]; }
+    const BlockID* column(int x, int z) const { return &blocks[index(x, z, 0)]; }
+
+    void fill(BlockID id) { blocks.fill(id); }
+
+private:
+    std::array<BlockID, SIZE> blocks{};
+};
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+Process
+
+1. Tasks are submitted round-robin onto one deque per worker thread, each
+   deque guarded by its own mutex so workers rarely contend. Every deque is
+   kept sorted by Task::priority, lowest value first.
+
+2. A worker pops tasks from the front of its own deque. Once that runs dry it
+   steals the front task of the other workers' deques, so a burst of requests
+   submitted while entering a fresh area spreads across every core while the
+   most urgent work is still picked first.
+
+3. Idle workers sleep on a single condition variable and are woken whenever
+   new work is submitted.
+
+4. resize() stops and joins every worker, gathers the tasks still waiting in
+   their deques, and redistributes them over the new set of workers. Tasks
+   already being processed finish before the join returns.
+
+5. reprioritize() rescores every queued task, sorts them and deals them out
+   again round-robin, keeping each deque ordered.
+*/
+
+/**
+ * @class WorkerPool
+ * @brief Sized thread pool with per-worker deques and work stealing.
+ *
+ * @tparam Task Value type handed to the handler on a worker thread. Must
+ * expose a float `priority` member; lower values are processed first.
+ */
+template <typename Task>
+class WorkerPool
+{
+public:
+    using Handler = std::function<void(Task&)>;
+    using Scorer = std::function<float(const Task&)>;
+
+    /**
+     * @return Default worker count: every hardware thread except the one
+     * reserved for rendering.
+     */
+    static int defaultWorkerCount()
+    {
+        int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+        return std::max(1, hardwareThreads - 1);
+    }
+
+    WorkerPool(Handler handler, int workerCount = defaultWorkerCount())
+        : handler(std::move(handler))
+    {
+        start(std::max(1, workerCount));
+    }
+
+    ~WorkerPool() { stop(); }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void submit(Task task)
+    {
+        std::lock_guard<std::mutex> resizeLock(resizeMutex);
+        unsigned int index = nextQueue++ % queues.size();
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            insertSorted(queues[index]->tasks, std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            pending++;
+        }
+        cv.notify_one();
+    }
+
+    /**
+     * @brief Submits a group of tasks at once, dealing them out in priority
+     * order so every worker starts on the most urgent ones.
+     */
+    void submitBatch(std::vector<Task>& tasks)
+    {
+        if (tasks.empty())
+            return;
+        sortByPriority(tasks);
+
+        std::lock_guard<std::mutex> resizeLock(resizeMutex);
+        for (auto& task : tasks)
+        {
+            unsigned int index = nextQueue++ % queues.size();
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            insertSorted(queues[index]->tasks, std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            pending += static_cast<int>(tasks.size());
+        }
+        cv.notify_all();
+        tasks.clear();
+    }
+
+    /**
+     * @brief Recomputes the priority of every queued task and reorders the
+     * deques accordingly.
+     */
+    void reprioritize(const Scorer& score)
+    {
+        std::lock_guard<std::mutex> resizeLock(resizeMutex);
+        std::vector<std::unique_lock<std::mutex>> locks;
+        std::vector<Task> queued;
+        for (auto& queue : queues)
+        {
+            locks.emplace_back(queue->mutex);
+            for (auto& task : queue->tasks)
+                queued.push_back(std::move(task));
+            queue->tasks.clear();
+        }
+
+        for (auto& task : queued)
+            task.priority = score(task);
+        sortByPriority(queued);
+
+        for (auto& task : queued)
+        {
+            unsigned int index = nextQueue++ % queues.size();
+            queues[index]->tasks.push_back(std::move(task));
+        }
+    }
+
+    /**
+     * @brief Drops every task that has not been picked up by a worker yet.
+     * @return Number of tasks dropped.
+     */
+    int clear()
+    {
+        std::lock_guard<std::mutex> resizeLock(resizeMutex);
+        int removed = 0;
+        for (auto& queue : queues)
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            removed += static_cast<int>(queue->tasks.size());
+            queue->tasks.clear();
+        }
+        pending -= removed;
+        return removed;
+    }
+
+    /**
+     * @brief Joins the workers after their current task and drops every
+     * queued task. Nothing submitted afterwards runs until resize().
+     * @return Number of tasks dropped.
+     */
+    int shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> resizeLock(resizeMutex);
+            stop();
+        }
+        return clear();
+    }
+
+    /**
+     * @brief Removes queued tasks matching a predicate.
+     * @return Number of tasks removed.
+     */
+    int removeIf(const std::function<bool(const Task&)>& predicate)
+    {
+        std::lock_guard<std::mutex> resizeLock(resizeMutex);
+        int removed = 0;
+        for (auto& queue : queues)
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            auto end = std::remove_if(queue->tasks.begin(), queue->tasks.end(),
+                                      predicate);
+            removed += static_cast<int>(queue->tasks.end() - end);
+            queue->tasks.erase(end, queue->tasks.end());
+        }
+        pending -= removed;
+        return removed;
+    }
+
+    /**
+     * @brief Changes the number of worker threads, keeping queued tasks.
+     */
+    void resize(int workerCount)
+    {
+        workerCount = std::max(1, workerCount);
+        std::lock_guard<std::mutex> resizeLock(resizeMutex);
+        if (workerCount == static_cast<int>(threads.size()))
+            return;
+
+        stop();
+        std::vector<Task> leftover;
+        for (auto& queue : queues)
+        {
+            for (auto& task : queue->tasks)
+                leftover.push_back(std::move(task));
+        }
+
+        createQueues(workerCount);
+        sortByPriority(leftover);
+        for (auto& task : leftover)
+        {
+            unsigned int index = nextQueue++ % queues.size();
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        pending = static_cast<int>(leftover.size());
+        launch();
+    }
+
+    int size() const { return static_cast<int>(threads.size()); }
+    int pendingCount() const { return pending.load(); }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    Handler handler;
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    unsigned int nextQueue = 0;
+
+    std::mutex resizeMutex;
+    std::mutex sleepMutex;
+    std::condition_variable cv;
+    std::atomic<int> pending{0};
+    std::atomic<bool> running{false};
+
+    static bool comparePriority(const Task& a, const Task& b)
+    {
+        return a.priority < b.priority;
+    }
+
+    static void sortByPriority(std::vector<Task>& tasks)
+    {
+        std::stable_sort(tasks.begin(), tasks.end(), comparePriority);
+    }
+
+    static void insertSorted(std::deque<Task>& tasks, Task task)
+    {
+        auto it = std::upper_bound(tasks.begin(), tasks.end(), task,
+                                   comparePriority);
+        tasks.insert(it, std::move(task));
+    }
+
+    void start(int workerCount)
+    {
+        createQueues(workerCount);
+        launch();
+    }
+
+    void createQueues(int workerCount)
+    {
+        queues.clear();
+        for (int i = 0; i < workerCount; ++i)
+            queues.push_back(std::make_unique<Queue>());
+    }
+
+    void launch()
+    {
+        running = true;
+        for (int i = 0; i < static_cast<int>(queues.size()); ++i)
+            threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            running = false;
+        }
+        cv.notify_all();
+        for (auto& thread : threads)
+        {
+            if (thread.joinable())
+                thread.join();
+        }
+        threads.clear();
+    }
+
+    bool popOwn(int index, Task& task)
+    {
+        Queue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            return false;
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        pending--;
+        return true;
+    }
+
+    bool steal(int thief, Task& task)
+    {
+        int count = static_cast<int>(queues.size());
+        for (int offset = 1; offset < count; ++offset)
+        {
+            Queue& victim = *queues[(thief + offset) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty())
+                continue;
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending--;
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(int index)
+    {
+        while (running)
+        {
+            Task task;
+            if (popOwn(index, task) || steal(index, task))
+            {
+                handler(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            cv.wait(lock, [this]() { return pending > 0 || !running; });
+        }
+    }
+};
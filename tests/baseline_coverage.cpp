@@ -0,0 +1,29 @@
+/*
+Writes tests/data/mesh_coverage.txt from the Mask2D/Used2D mesher the binary
+mesher replaced, which the mesh_golden suite compares the current mesher
+against. Not part of the build, it compiles against the original tree:
+
+    git worktree add /tmp/voxel-baseline 933288d
+    g++ -std=c++17 -O2 -I/tmp/voxel-baseline/src -I/tmp/voxel-baseline/include \
+        tests/baseline_coverage.cpp /tmp/voxel-baseline/src/noise/perlin_gen.cpp \
+        -o baseline_coverage
+    ./baseline_coverage > tests/data/mesh_coverage.txt
+    git worktree remove /tmp/voxel-baseline
+*/
+
+#include <iostream>
+
+#include "noise/perlin_gen.hpp"
+#include "mesh_coverage.hpp"
+
+int main() {
+    // the original mesher emitted two triangles per quad
+    const int quadVertices = 6;
+    std::cout << "# Mask2D/Used2D mesher at 933288d, written by tests/baseline_coverage.cpp\n";
+    std::cout << "# chunk_x chunk_z faces(+x -x +y -y +z -z) fnv1a64(cells)\n";
+    for (glm::ivec2 chunk : GOLDEN_CHUNKS) {
+        std::vector<Vertex> vertices = PerlinGen::generate(TERRAIN_SCALE, chunk.x, chunk.y);
+        std::cout << describeCoverage(faceCoverage(vertices, quadVertices, chunk), chunk) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "shader_stub.hpp"
+#include "tools/streaming.hpp"
+#include "world/chunk_gen.hpp"
+#include "world/null_backend.hpp"
+
+/*
+Helpers for tests driving a ChunkManager against a NullBackend.
+*/
+
+/**
+ * Shader for the passes, NullBackend never reads it.
+ */
+inline const Shader& noShader() {
+    static const Shader shader;
+    return shader;
+}
+
+/** Camera position of topDownView(), above chunk (0, 0) and every block */
+inline const glm::vec3 TOP_DOWN_CAMERA(8.0f, 100.0f, 8.0f);
+
+/**
+ * Orthographic view straight down from TOP_DOWN_CAMERA covering every chunk
+ * within radius of the origin.
+ */
+inline glm::mat4 topDownView(int radius) {
+    float extent = (radius + 1) * 16.0f;
+    glm::mat4 projection = glm::ortho(-extent, extent, -extent, extent, 1.0f, 200.0f);
+    glm::mat4 view = glm::lookAt(TOP_DOWN_CAMERA, TOP_DOWN_CAMERA - glm::vec3(0.0f, 1.0f, 0.0f),
+                                 glm::vec3(0.0f, 0.0f, 1.0f));
+    return projection * view;
+}
+
+/**
+ * Loads every chunk within radius of chunk (x, z) and waits for the uploads.
+ */
+inline void loadAround(ChunkManager& chunkManager, int x, int z, int radius) {
+    std::size_t uploadedBytes = 0;
+    chunkManager.update(x, z, radius, glm::vec3(1.0f, 0.0f, 0.0f));
+    settle(chunkManager, uploadedBytes);
+}
@@ -0,0 +1,109 @@
+#include "test.hpp"
+#include "chunk_fixture.hpp"
+
+static constexpr int RADIUS = 3;
+static constexpr int CHUNKS = (2 * RADIUS + 1) * (2 * RADIUS + 1);
+
+TEST(chunk_render, one_submission_per_batch_group) {
+    ChunkManager chunkManager(std::make_unique<NullBackend>());
+    loadAround(chunkManager, 0, 0, RADIUS);
+    CHECK_EQ(chunkManager.getPipelineCounters().resident, CHUNKS);
+
+    chunkManager.render(noShader(), topDownView(RADIUS), TOP_DOWN_CAMERA);
+    PassStats stats = chunkManager.getTerrainStats();
+    CHECK_EQ(stats.chunksDrawn, CHUNKS);
+    CHECK_EQ(stats.chunksCulled, 0);
+    // NullBackend has a single batch group
+    CHECK_EQ(stats.drawCalls, 1);
+    // neighboring visible directions share a range, at most 3 per chunk
+    CHECK(stats.drawRanges >= stats.chunksDrawn);
+    CHECK(stats.drawRanges <= 3 * stats.chunksDrawn);
+    CHECK_EQ(stats.trianglesDrawn + stats.trianglesSkipped,
+             chunkManager.getResidentTriangles());
+    // from above, no bottom faces are drawn
+    CHECK(stats.trianglesSkipped > 0);
+    chunkManager.shutdown();
+}
+
+TEST(chunk_render, nothing_submitted_when_culled) {
+    ChunkManager chunkManager(std::make_unique<NullBackend>());
+    loadAround(chunkManager, 0, 0, RADIUS);
+
+    // the same view, moved far away from the loaded chunks
+    glm::mat4 away = topDownView(RADIUS) *
+                     glm::translate(glm::mat4(1.0f), glm::vec3(-10000.0f, 0.0f, 0.0f));
+    chunkManager.render(noShader(), away, TOP_DOWN_CAMERA);
+    PassStats stats = chunkManager.getTerrainStats();
+    CHECK_EQ(stats.chunksDrawn, 0);
+    CHECK_EQ(stats.chunksCulled, CHUNKS);
+    CHECK_EQ(stats.drawCalls, 0);
+    CHECK_EQ(stats.drawRanges, 0);
+    chunkManager.shutdown();
+}
+
+TEST(chunk_render, shadow_pass_draws_lit_faces_only) {
+    ChunkManager chunkManager(std::make_unique<NullBackend>());
+    loadAround(chunkManager, 0, 0, RADIUS);
+
+    // sun straight overhead: only the top faces, one range per chunk
+    chunkManager.renderShadow(noShader(), topDownView(RADIUS), glm::vec3(0.0f, 1.0f, 0.0f));
+    PassStats stats = chunkManager.getShadowStats();
+    CHECK_EQ(stats.chunksDrawn, CHUNKS);
+    CHECK_EQ(stats.drawCalls, 1);
+    CHECK_EQ(stats.drawRanges, CHUNKS);
+    CHECK_EQ(stats.trianglesDrawn + stats.trianglesSkipped,
+             chunkManager.getResidentTriangles());
+    chunkManager.shutdown();
+}
+
+/**
+ * NullBackend that counts layout switches made while meshes were still
+ * allocated, and uploads of meshes in another format than the current one.
+ */
+class FormatCheckingBackend : public NullBackend {
+    public:
+        int switchesWithMeshes = 0;
+        int mismatchedUploads = 0;
+
+        void setVertexFormat(VertexFormat vertexFormat) override {
+            if (getStats().arena.allocations > 0) switchesWithMeshes++;
+            format = vertexFormat;
+            NullBackend::setVertexFormat(vertexFormat);
+        }
+
+        int upload(const ChunkMesh& mesh, const StagingBlock& staging,
+                   const glm::ivec3& origin) override {
+            if (mesh.format != format) mismatchedUploads++;
+            return NullBackend::upload(mesh, staging, origin);
+        }
+
+    private:
+        VertexFormat format = VertexFormat::Packed;
+};
+
+TEST(chunk_render, format_switch_releases_every_mesh_first) {
+    auto backend = std::make_unique<FormatCheckingBackend>();
+    FormatCheckingBackend& checked = *backend;
+    ChunkManager chunkManager(std::move(backend));
+    loadAround(chunkManager, 0, 0, RADIUS);
+    MeshMemory packed = chunkManager.getMeshMemory();
+    CHECK_EQ(packed.gpuBytes, static_cast<std::size_t>(packed.vertices) * sizeof(PackedVertex));
+
+    // toggled with chunks loaded, both ways
+    chunkManager.setVertexFormat(VertexFormat::Float);
+    CHECK_EQ(chunkManager.getPipelineCounters().resident, 0);
+    loadAround(chunkManager, 0, 0, RADIUS);
+    MeshMemory floats = chunkManager.getMeshMemory();
+    CHECK_EQ(floats.vertices, packed.vertices);
+    CHECK_EQ(floats.gpuBytes, static_cast<std::size_t>(floats.vertices) * sizeof(Vertex));
+    chunkManager.render(noShader(), topDownView(RADIUS), TOP_DOWN_CAMERA);
+    CHECK_EQ(chunkManager.getTerrainStats().chunksDrawn, CHUNKS);
+
+    chunkManager.setVertexFormat(VertexFormat::Packed);
+    loadAround(chunkManager, 0, 0, RADIUS);
+    CHECK_EQ(chunkManager.getMeshMemory().gpuBytes, packed.gpuBytes);
+
+    CHECK_EQ(checked.switchesWithMeshes, 0);
+    CHECK_EQ(checked.mismatchedUploads, 0);
+    chunkManager.shutdown();
+}
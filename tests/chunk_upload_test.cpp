@@ -0,0 +1,70 @@
+#include "test.hpp"
+#include "chunk_fixture.hpp"
+
+#include <thread>
+
+// either side of the frame time the budget adapts to
+static constexpr float FAST_FRAME = TARGET_FRAME_TIME * 0.5f;
+static constexpr float SLOW_FRAME = TARGET_FRAME_TIME * FRAME_TIME_TOLERANCE * 2.0f;
+
+TEST(chunk_upload, budget_halves_on_slow_frames_and_grows_back) {
+    ChunkManager chunkManager(std::make_unique<NullBackend>());
+    chunkManager.uploadMesh(SLOW_FRAME);
+    CHECK_EQ(chunkManager.getUploadStats().budgetMs, INITIAL_UPLOAD_BUDGET_MS * 0.5f);
+    for (int i = 0; i < 100 && chunkManager.getUploadStats().budgetMs > MIN_UPLOAD_BUDGET_MS; i++) {
+        chunkManager.uploadMesh(SLOW_FRAME);
+    }
+    CHECK_EQ(chunkManager.getUploadStats().budgetMs, MIN_UPLOAD_BUDGET_MS);
+    chunkManager.uploadMesh(SLOW_FRAME);
+    CHECK_EQ(chunkManager.getUploadStats().budgetMs, MIN_UPLOAD_BUDGET_MS);
+
+    chunkManager.uploadMesh(FAST_FRAME);
+    CHECK_EQ(chunkManager.getUploadStats().budgetMs, MIN_UPLOAD_BUDGET_MS + UPLOAD_BUDGET_STEP_MS);
+    int steps = static_cast<int>((MAX_UPLOAD_BUDGET_MS - MIN_UPLOAD_BUDGET_MS) / UPLOAD_BUDGET_STEP_MS);
+    for (int i = 0; i < steps + 10; i++) chunkManager.uploadMesh(FAST_FRAME);
+    CHECK_EQ(chunkManager.getUploadStats().budgetMs, MAX_UPLOAD_BUDGET_MS);
+}
+
+TEST(chunk_upload, frames_stay_within_the_byte_cap) {
+    ChunkManager chunkManager(std::make_unique<NullBackend>());
+    // float vertices, so the whole world is well over one frame's cap
+    chunkManager.setVertexFormat(VertexFormat::Float);
+    chunkManager.update(0, 0, 10, glm::vec3(1.0f, 0.0f, 0.0f));
+    while (chunkManager.getGenerationCounters().completed <
+           chunkManager.getGenerationCounters().requested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // the largest mesh bounds how far the last upload of a frame overshoots
+    std::size_t largestMesh = 16 * 16 * 32 * 6 * QUAD_VERTICES * sizeof(Vertex);
+    int frames = 0;
+    std::size_t total = 0;
+    UploadStats uploads;
+    do {
+        chunkManager.uploadMesh(FAST_FRAME);
+        uploads = chunkManager.getUploadStats();
+        CHECK(uploads.uploadsLastFrame >= 1);
+        CHECK(uploads.bytesLastFrame < MAX_UPLOAD_BYTES_PER_FRAME + largestMesh);
+        total += uploads.bytesLastFrame;
+        frames++;
+    } while (uploads.backlog > 0);
+    CHECK(frames > 1);
+    CHECK_EQ(total, chunkManager.getMeshMemory().gpuBytes);
+    chunkManager.shutdown();
+}
+
+TEST(chunk_upload, first_ring_timer_completes) {
+    ChunkManager chunkManager(std::make_unique<NullBackend>());
+    loadAround(chunkManager, 0, 0, 4);
+    // ends on the first upload frame after the ring is resident
+    chunkManager.uploadMesh(FAST_FRAME);
+    float first = chunkManager.getFirstRingTime();
+    CHECK(first > 0.0f);
+
+    // a jump to unloaded terrain measures again
+    loadAround(chunkManager, 100, 0, 4);
+    chunkManager.uploadMesh(FAST_FRAME);
+    CHECK(chunkManager.getFirstRingTime() > 0.0f);
+    CHECK(chunkManager.getFirstRingTime() != first);
+    chunkManager.shutdown();
+}
@@ -0,0 +1,151 @@
+#include "test.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "core/flythrough.hpp"
+
+using namespace Engine;
+
+static BenchmarkOptions benchmark(FlightPath path, unsigned int seed = 1) {
+    BenchmarkOptions options;
+    options.enabled = true;
+    options.path = path;
+    options.seed = seed;
+    return options;
+}
+
+static bool samePose(const CameraPose& a, const CameraPose& b) {
+    return a.position == b.position && a.yaw == b.yaw && a.pitch == b.pitch;
+}
+
+static bool parse(std::vector<const char*> args, BenchmarkOptions& options) {
+    args.insert(args.begin(), "Voxel-Engine");
+    return parseCommandLine(static_cast<int>(args.size()), const_cast<char**>(args.data()),
+                            options);
+}
+
+TEST(flythrough, parses_the_command_line) {
+    BenchmarkOptions options;
+    CHECK(parse({"--bench", "spiral", "--frames", "300", "--seed", "7", "--out", "run"}, options));
+    CHECK(options.enabled);
+    CHECK(options.path == FlightPath::Spiral);
+    CHECK_EQ(options.frames, 300);
+    CHECK_EQ(options.seed, 7u);
+    CHECK_EQ(options.output, std::string("run"));
+
+    BenchmarkOptions recorded;
+    CHECK(parse({"--bench", "poses.txt"}, recorded));
+    CHECK(recorded.path == FlightPath::Recorded);
+    CHECK_EQ(recorded.recording, std::string("poses.txt"));
+
+    // benchmarks never record, unknown and incomplete arguments fail
+    BenchmarkOptions rejected;
+    CHECK(!parse({"--bench", "sprint", "--record", "poses.txt"}, rejected));
+    CHECK(!parse({"--fast"}, rejected));
+    CHECK(!parse({"--frames"}, rejected));
+    CHECK(!parse({"--frames", "-5"}, rejected));
+}
+
+TEST(flythrough, scripted_paths_are_deterministic) {
+    for (FlightPath path : {FlightPath::Sprint, FlightPath::Spiral, FlightPath::Teleport}) {
+        Flythrough a(benchmark(path, 3));
+        Flythrough b(benchmark(path, 3));
+        CHECK(a.load() && b.load());
+        CHECK_EQ(a.frameCount(), b.frameCount());
+        for (int frame = 0; frame < a.frameCount(); frame += 7) {
+            CHECK(samePose(a.poseAt(frame), b.poseAt(frame)));
+        }
+    }
+}
+
+TEST(flythrough, teleports_depend_on_the_seed) {
+    Flythrough a(benchmark(FlightPath::Teleport, 3));
+    Flythrough b(benchmark(FlightPath::Teleport, 4));
+    int differing = 0;
+    for (int frame = 0; frame < a.frameCount(); frame += 90) {
+        if (a.poseAt(frame).position != b.poseAt(frame).position) differing++;
+    }
+    CHECK(differing > 0);
+
+    // between jumps the camera stays put and only turns
+    CHECK(a.poseAt(90).position == a.poseAt(179).position);
+    CHECK(a.poseAt(179).yaw > a.poseAt(90).yaw);
+}
+
+TEST(flythrough, paths_move_at_constant_speed) {
+    Flythrough sprint(benchmark(FlightPath::Sprint));
+    Flythrough spiral(benchmark(FlightPath::Spiral));
+    // blocks per second at 60 frames per second
+    for (int frame = 60; frame < 1800; frame += 60) {
+        float sprintSpeed = glm::length(sprint.poseAt(frame + 1).position - sprint.poseAt(frame).position) * 60.0f;
+        float spiralSpeed = glm::length(spiral.poseAt(frame + 1).position - spiral.poseAt(frame).position) * 60.0f;
+        CHECK(sprintSpeed > 31.9f && sprintSpeed < 32.1f);
+        CHECK(spiralSpeed > 22.0f && spiralSpeed < 26.0f);
+    }
+}
+
+TEST(flythrough, replays_a_recording) {
+    Flythrough teleport(benchmark(FlightPath::Teleport, 5));
+    const std::string file = "flythrough_test_poses.txt";
+    {
+        std::ofstream recording(file);
+        for (int i = 0; i < 50; i++) writePose(recording, teleport.poseAt(i * 36));
+    }
+
+    BenchmarkOptions options = benchmark(FlightPath::Recorded);
+    options.recording = file;
+    Flythrough replay(options);
+    CHECK(replay.load());
+    CHECK_EQ(replay.frameCount(), 50);
+    for (int i = 0; i < 50; i++) {
+        CameraPose expected = teleport.poseAt(i * 36);
+        CameraPose pose = replay.poseAt(i);
+        CHECK(glm::length(pose.position - expected.position) < 0.01f);
+        CHECK(std::abs(pose.yaw - expected.yaw) < 0.01f);
+    }
+    // frames past the end hold the last pose
+    CHECK(samePose(replay.poseAt(80), replay.poseAt(49)));
+    std::remove(file.c_str());
+
+    options.recording = "missing_flythrough_poses.txt";
+    Flythrough missing(options);
+    CHECK(!missing.load());
+}
+
+TEST(flythrough, writes_percentiles) {
+    BenchmarkOptions options = benchmark(FlightPath::Sprint);
+    options.frames = 100;
+    options.output = "flythrough_test_results";
+    Flythrough flythrough(options);
+    for (int i = 0; i < 100; i++) {
+        FrameSample sample;
+        // CPU times 1..100 ms give exact nearest-rank percentiles, two frames are hitches
+        sample.frameMs = i < 98 ? 10.0 : 50.0;
+        sample.cpuMs = i + 1;
+        sample.chunksGenerated = i;
+        sample.uploadBacklog = i % 7;
+        flythrough.addFrame(sample);
+    }
+    CHECK(flythrough.isFinished());
+    // late GPU results land in their frame, unknown frames are ignored
+    flythrough.setGpuTime(3, 2.5);
+    flythrough.setGpuTime(500, 9.0);
+    CHECK(flythrough.writeResults("test \"renderer\"", 8));
+
+    std::ifstream file(options.output + ".json");
+    std::stringstream json;
+    json << file.rdbuf();
+    const std::string text = json.str();
+    CHECK(text.find("\"path\": \"sprint\"") != std::string::npos);
+    CHECK(text.find("\"renderer\": \"test \\\"renderer\\\"\"") != std::string::npos);
+    CHECK(text.find("\"p50\": 50, \"p95\": 95, \"p99\": 99, \"max\": 100") != std::string::npos);
+    CHECK(text.find("\"gpu_ms\": {\"samples\": 1,") != std::string::npos);
+    CHECK(text.find("\"hitches_over_33ms\": 2") != std::string::npos);
+    CHECK(text.find("\"chunks_generated\": 99") != std::string::npos);
+    CHECK(text.find("\"max_upload_backlog\": 6") != std::string::npos);
+    std::remove((options.output + ".csv").c_str());
+    std::remove((options.output + ".json").c_str());
+}
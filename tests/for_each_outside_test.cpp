@@ -0,0 +1,58 @@
+#include "test.hpp"
+
+#include <set>
+#include <utility>
+
+#include "world/toroidal_grid.hpp"
+
+using Coords = std::set<std::pair<int, int>>;
+
+static Coords square(glm::ivec2 center, int radius) {
+    Coords coords;
+    for (int x = center.x - radius; x <= center.x + radius; x++)
+        for (int z = center.y - radius; z <= center.y + radius; z++) coords.insert({x, z});
+    return coords;
+}
+
+/**
+ * forEachOutside() against the set difference of the two squares, and
+ * checks no coordinate is visited twice.
+ */
+static void checkOutside(glm::ivec2 a, int radiusA, glm::ivec2 b, int radiusB) {
+    Coords expected = square(a, radiusA);
+    if (radiusB >= 0) {
+        for (const auto& coord : square(b, radiusB)) expected.erase(coord);
+    }
+
+    Coords visited;
+    int calls = 0;
+    forEachOutside(a, radiusA, b, radiusB, [&](int x, int z) {
+        visited.insert({x, z});
+        calls++;
+    });
+    CHECK_EQ(calls, static_cast<int>(visited.size()));
+    CHECK(visited == expected);
+}
+
+TEST(for_each_outside, empty_second_square_visits_everything) {
+    checkOutside({0, 0}, 3, {0, 0}, -1);
+    checkOutside({-5, 9}, 0, {100, 100}, -1);
+}
+
+TEST(for_each_outside, moves_and_radius_changes) {
+    // every offset up to beyond the squares' width, growing and shrinking
+    for (int dx = -9; dx <= 9; dx++) {
+        for (int dz = -9; dz <= 9; dz++) {
+            for (int radiusB : {0, 2, 4, 6}) {
+                checkOutside({0, 0}, 4, {dx, dz}, radiusB);
+                checkOutside({dx, dz}, radiusB, {0, 0}, 4);
+            }
+        }
+    }
+}
+
+TEST(for_each_outside, same_square_visits_nothing) {
+    int calls = 0;
+    forEachOutside({7, -3}, 5, {7, -3}, 5, [&](int, int) { calls++; });
+    CHECK_EQ(calls, 0);
+}
@@ -0,0 +1,93 @@
+#include "test.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "world/latency_histogram.hpp"
+
+/**
+ * Upper edge of the bucket holding value: the median of value and a value
+ * far above it, which percentile() does not clamp to value.
+ */
+static std::int64_t bucketEdge(std::int64_t value) {
+    LatencyHistogram histogram;
+    histogram.record(value);
+    histogram.record(LatencyHistogram::MAX_MICROSECONDS);
+    return histogram.percentile(50.0);
+}
+
+TEST(latency_histogram, small_values_are_exact) {
+    for (std::int64_t value = 0; value < LatencyHistogram::SUB_BUCKETS; value++) {
+        CHECK_EQ(bucketEdge(value), value);
+    }
+    // the first shared bucket holds 64 and 65
+    CHECK_EQ(bucketEdge(64), std::int64_t(65));
+    CHECK_EQ(bucketEdge(65), std::int64_t(65));
+    CHECK_EQ(bucketEdge(66), std::int64_t(67));
+}
+
+TEST(latency_histogram, bucket_edges) {
+    int failures = 0;
+    for (std::int64_t value = 1; value < LatencyHistogram::MAX_MICROSECONDS;
+         value = value + value / 64 + 1) {
+        std::int64_t edge = bucketEdge(value);
+        // within 1 / SUB_BUCKETS_HALF above the value, the edge is its own
+        // bucket's edge and the next value starts a new bucket
+        bool bounded = edge >= value &&
+                       edge - value < std::max<std::int64_t>(value / LatencyHistogram::SUB_BUCKETS_HALF, 1);
+        bool closed = bucketEdge(edge) == edge &&
+                      (edge == LatencyHistogram::MAX_MICROSECONDS || bucketEdge(edge + 1) > edge);
+        if (!bounded || !closed) {
+            std::cerr << "value " << value << " edge " << edge << '\n';
+            failures++;
+        }
+    }
+    CHECK_EQ(failures, 0);
+}
+
+TEST(latency_histogram, percentiles_bound_the_true_values) {
+    // frame-like durations spanning several magnitudes
+    std::mt19937_64 random(1);
+    std::lognormal_distribution<double> duration(8.0, 2.0);
+    LatencyHistogram histogram;
+    std::vector<std::int64_t> values;
+    for (int i = 0; i < 100000; i++) {
+        std::int64_t value = static_cast<std::int64_t>(duration(random));
+        histogram.record(value);
+        values.push_back(std::min(value, LatencyHistogram::MAX_MICROSECONDS));
+    }
+    std::sort(values.begin(), values.end());
+    CHECK_EQ(histogram.count(), 100000LL);
+    CHECK_EQ(histogram.max(), values.back());
+
+    for (double p : {0.1, 1.0, 10.0, 50.0, 90.0, 99.0, 99.9, 100.0}) {
+        std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * values.size()));
+        std::int64_t exact = values[std::max<std::size_t>(rank, 1) - 1];
+        std::int64_t estimate = histogram.percentile(p);
+        CHECK(estimate >= exact);
+        CHECK(estimate - exact <= exact / LatencyHistogram::SUB_BUCKETS_HALF);
+    }
+    CHECK_EQ(histogram.percentile(100.0), histogram.max());
+}
+
+TEST(latency_histogram, clamps_and_clears) {
+    LatencyHistogram histogram;
+    CHECK_EQ(histogram.percentile(99.0), std::int64_t(0));
+    CHECK_EQ(histogram.mean(), 0.0);
+
+    histogram.record(-5);
+    histogram.record(LatencyHistogram::MAX_MICROSECONDS + 1000);
+    CHECK_EQ(histogram.count(), 2LL);
+    CHECK_EQ(histogram.percentile(0.0), std::int64_t(0));
+    CHECK_EQ(histogram.percentile(100.0), LatencyHistogram::MAX_MICROSECONDS);
+    CHECK_EQ(histogram.max(), LatencyHistogram::MAX_MICROSECONDS);
+    CHECK_EQ(histogram.mean(), LatencyHistogram::MAX_MICROSECONDS / 2.0);
+
+    histogram.clear();
+    CHECK_EQ(histogram.count(), 0LL);
+    CHECK_EQ(histogram.max(), std::int64_t(0));
+    CHECK_EQ(histogram.percentile(50.0), std::int64_t(0));
+    histogram.record(10);
+    CHECK_EQ(histogram.percentile(50.0), std::int64_t(10));
+}
@@ -0,0 +1,63 @@
+#include "test.hpp"
+
+#include <memory>
+
+#include "world/lru_cache.hpp"
+
+TEST(lru_cache, evicts_oldest_insert_first) {
+    std::vector<int> evicted;
+    LruCache<int, int> cache(3, [&](int& value) { evicted.push_back(value); });
+    for (int key = 1; key <= 5; key++) cache.put(key, key * 10);
+
+    CHECK_EQ(cache.size(), std::size_t(3));
+    CHECK(evicted == std::vector<int>({10, 20}));
+    CHECK(!cache.take(1).has_value());
+    CHECK(!cache.take(2).has_value());
+    CHECK_EQ(cache.take(3).value_or(-1), 30);
+    CHECK_EQ(cache.take(5).value_or(-1), 50);
+    CHECK_EQ(cache.size(), std::size_t(1));
+}
+
+TEST(lru_cache, take_removes_without_evicting) {
+    int evictions = 0;
+    LruCache<int, std::unique_ptr<int>> cache(4, [&](std::unique_ptr<int>&) { evictions++; });
+    cache.put(7, std::make_unique<int>(70));
+
+    std::optional<std::unique_ptr<int>> taken = cache.take(7);
+    CHECK(taken.has_value() && **taken == 70);
+    CHECK(!cache.take(7).has_value());
+    CHECK_EQ(cache.size(), std::size_t(0));
+    CHECK_EQ(evictions, 0);
+}
+
+TEST(lru_cache, put_replaces_and_refreshes) {
+    std::vector<int> evicted;
+    LruCache<int, int> cache(2, [&](int& value) { evicted.push_back(value); });
+    cache.put(1, 10);
+    cache.put(2, 20);
+    // replacing key 1 evicts its old value and makes it the newest entry
+    cache.put(1, 11);
+    CHECK(evicted == std::vector<int>({10}));
+    cache.put(3, 30);
+    CHECK(evicted == std::vector<int>({10, 20}));
+    CHECK_EQ(cache.take(1).value_or(-1), 11);
+}
+
+TEST(lru_cache, shrinking_and_clear_evict) {
+    std::vector<int> evicted;
+    LruCache<int, int> cache(4, [&](int& value) { evicted.push_back(value); });
+    for (int key = 1; key <= 4; key++) cache.put(key, key);
+
+    cache.setCapacity(2);
+    CHECK_EQ(cache.capacity(), std::size_t(2));
+    CHECK(evicted == std::vector<int>({1, 2}));
+
+    cache.clear();
+    CHECK_EQ(cache.size(), std::size_t(0));
+    CHECK_EQ(evicted.size(), std::size_t(4));
+
+    cache.setCapacity(0);
+    cache.put(9, 9);
+    CHECK_EQ(cache.size(), std::size_t(0));
+    CHECK_EQ(evicted.back(), 9);
+}
@@ -0,0 +1,86 @@
+#include "test.hpp"
+#include "chunk_fixture.hpp"
+
+#include <cstring>
+
+#include "noise/perlin_gen.hpp"
+#include "world/mesh_codec.hpp"
+
+/**
+ * Compresses and restores a vertex array, true if every byte survived.
+ */
+static bool roundTrips(const void* vertices, std::size_t count, std::size_t stride) {
+    std::vector<std::uint8_t> compressed = compressVertices(vertices, count, stride);
+    std::vector<std::uint8_t> restored(count * stride + 1, 0xAB);
+    decompressVertices(compressed, restored.data(), count, stride);
+    // nothing written past the end
+    return std::memcmp(restored.data(), vertices, count * stride) == 0 &&
+           restored.back() == 0xAB;
+}
+
+TEST(mesh_codec, round_trips_chunk_meshes) {
+    const int chunks[][2] = {{0, 0}, {3, -7}, {-40, 12}, {150, 90}};
+    for (const auto& chunk : chunks) {
+        for (VertexFormat format : {VertexFormat::Float, VertexFormat::Packed}) {
+            ChunkMesh mesh = PerlinGen::generate(0.05f, chunk[0], chunk[1], format);
+            CHECK(roundTrips(mesh.data(), mesh.vertexCount(), mesh.stride()));
+
+            // voxel meshes are mostly repeated bytes
+            std::vector<std::uint8_t> compressed =
+                compressVertices(mesh.data(), mesh.vertexCount(), mesh.stride());
+            CHECK(compressed.size() < mesh.byteSize() / 2);
+        }
+    }
+}
+
+TEST(mesh_codec, round_trips_edge_cases) {
+    std::uint8_t single[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    CHECK(roundTrips(single, 1, sizeof(single)));
+
+    // long zero runs, in and across planes
+    std::vector<std::uint8_t> zeros(8 * 1000, 0);
+    CHECK(roundTrips(zeros.data(), 1000, 8));
+    std::vector<std::uint8_t> constant(36 * 700, 0x5A);
+    CHECK(roundTrips(constant.data(), 700, 36));
+
+    // no repetition at all: every byte differs from the previous one
+    std::vector<std::uint8_t> noisy(8 * 513);
+    std::uint32_t state = 12345;
+    for (std::uint8_t& byte : noisy) {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<std::uint8_t>(state >> 24);
+    }
+    CHECK(roundTrips(noisy.data(), 513, 8));
+
+    // differences that wrap around 0 and 255
+    std::vector<std::uint8_t> wrapping(4 * 300);
+    for (std::size_t i = 0; i < wrapping.size(); i++) {
+        wrapping[i] = static_cast<std::uint8_t>(i % 2 == 0 ? 0 : 255);
+    }
+    CHECK(roundTrips(wrapping.data(), 300, 4));
+}
+
+TEST(mesh_codec, cached_chunks_reupload_from_compressed_copies) {
+    ChunkManager chunkManager(std::make_unique<NullBackend>());
+    chunkManager.setCompressedCopies(true);
+    loadAround(chunkManager, 0, 0, 3);
+    MeshMemory loaded = chunkManager.getMeshMemory();
+    CHECK(loaded.compressedBytes > 0);
+    CHECK(loaded.compressedBytes < loaded.gpuBytes);
+    CHECK_EQ(loaded.queuedBytes, std::size_t(0));
+
+    // far enough for every chunk to leave the unload margin into the cache,
+    // giving up its GPU range
+    loadAround(chunkManager, 50, 0, 3);
+    loadAround(chunkManager, 0, 0, 3);
+    CacheStats cache = chunkManager.getCacheStats();
+    CHECK_EQ(cache.hits, 49LL);
+    CHECK_EQ(cache.reuploads, 49LL);
+
+    // the same meshes are back on the GPU
+    MeshMemory restored = chunkManager.getMeshMemory();
+    CHECK_EQ(restored.vertices, loaded.vertices);
+    CHECK_EQ(restored.gpuBytes, loaded.gpuBytes);
+    CHECK_EQ(chunkManager.getPipelineCounters().resident, 49);
+    chunkManager.shutdown();
+}
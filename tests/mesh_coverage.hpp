@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <stb_perlin.h>
+#include <glm/glm.hpp>
+
+/*
+Block faces covered by a mesh, independent of how they were merged into
+quads and of the vertex layout. Only needs a vertex type with position,
+normal and texID, so tests/baseline_coverage.cpp builds it against the
+original mesher as well.
+*/
+
+/** Scale ChunkManager generates terrain with */
+static constexpr float TERRAIN_SCALE = 0.05f;
+
+// chunk dimensions of perlin_gen.cpp
+static constexpr int CHUNK_WIDTH = 16;
+static constexpr int CHUNK_LENGTH = 16;
+static constexpr int CHUNK_HEIGHT = 32;
+
+/** Chunks the mesh tests and their data files cover */
+static const glm::ivec2 GOLDEN_CHUNKS[] = {
+    {0, 0}, {1, 0}, {0, 1}, {-1, -1}, {5, -3},
+    {-8, 12}, {17, 4}, {-20, -20}, {64, -37}, {-300, 150},
+};
+
+// texture ids of perlin_gen.cpp
+static constexpr int TOP_TEXTURE = 2;
+static constexpr int FLOWER_TEXTURE = 3;
+
+/**
+ * Solidity of a world block, computed the same way as PerlinGen::generate().
+ */
+static bool isSolid(int x, int y, int z) {
+    if (y < 0 || y >= CHUNK_HEIGHT) return false;
+    float noiseValue = stb_perlin_noise3(x * TERRAIN_SCALE, y * TERRAIN_SCALE,
+                                         z * TERRAIN_SCALE, 0, 0, 0);
+    float heightGradient = (static_cast<float>(y) / CHUNK_HEIGHT) * 2.0f - 1.0f;
+    return noiseValue - heightGradient > 0.0f;
+}
+
+/**
+ * One exposed block face: direction in Face order (+x -x +y -y +z -z),
+ * world block and texture.
+ */
+struct FaceCell {
+    int face;
+    int x, y, z;
+    int texture;
+
+    bool operator<(const FaceCell& other) const {
+        return std::tie(face, x, y, z, texture) <
+               std::tie(other.face, other.x, other.y, other.z, other.texture);
+    }
+    bool operator==(const FaceCell& other) const {
+        return std::tie(face, x, y, z, texture) ==
+               std::tie(other.face, other.x, other.y, other.z, other.texture);
+    }
+};
+
+/**
+ * Splits every quad of a mesh into the block faces it covers, sorted.
+ *
+ * Flowers count as grass: the original mesher picked them with a
+ * random_device, so only their presence as a top face is comparable.
+ * Faces on the chunk's sides that a solid block of the neighboring chunk
+ * hides are dropped, since only the original mesher emits them.
+ */
+template <typename VertexType>
+std::vector<FaceCell> faceCoverage(const std::vector<VertexType>& vertices, int quadVertices,
+                                   glm::ivec2 chunk) {
+    std::vector<FaceCell> cells;
+    glm::ivec3 chunkMin(chunk.x * CHUNK_WIDTH, 0, chunk.y * CHUNK_LENGTH);
+    glm::ivec3 chunkMax = chunkMin + glm::ivec3(CHUNK_WIDTH, CHUNK_HEIGHT, CHUNK_LENGTH);
+
+    for (std::size_t first = 0; first + quadVertices <= vertices.size(); first += quadVertices) {
+        glm::vec3 low = vertices[first].position;
+        glm::vec3 high = low;
+        for (int i = 1; i < quadVertices; i++) {
+            low = glm::min(low, vertices[first + i].position);
+            high = glm::max(high, vertices[first + i].position);
+        }
+        glm::ivec3 normal = glm::ivec3(glm::round(vertices[first].normal));
+        int axis = normal.x != 0 ? 0 : normal.y != 0 ? 1 : 2;
+        int sign = normal[axis];
+        int face = axis * 2 + (sign > 0 ? 0 : 1);
+        int texture = static_cast<int>(vertices[first].texID);
+        if (texture == FLOWER_TEXTURE) texture = TOP_TEXTURE;
+
+        glm::ivec3 from = glm::ivec3(glm::round(low));
+        glm::ivec3 to = glm::ivec3(glm::round(high));
+        // the face lies on the block's far side for positive normals
+        if (sign > 0) from[axis] -= 1;
+        to[axis] = from[axis] + 1;
+
+        for (int x = from.x; x < to.x; x++) {
+            for (int y = from.y; y < to.y; y++) {
+                for (int z = from.z; z < to.z; z++) {
+                    glm::ivec3 neighbor = glm::ivec3(x, y, z) + normal;
+                    bool outside = neighbor.x < chunkMin.x || neighbor.x >= chunkMax.x ||
+                                   neighbor.z < chunkMin.z || neighbor.z >= chunkMax.z;
+                    if (outside && isSolid(neighbor.x, neighbor.y, neighbor.z)) continue;
+                    cells.push_back({face, x, y, z, texture});
+                }
+            }
+        }
+    }
+    std::sort(cells.begin(), cells.end());
+    return cells;
+}
+
+/**
+ * One line of tests/data/mesh_coverage.txt: chunk, faces per direction and
+ * an FNV-1a hash of every cell.
+ */
+inline std::string describeCoverage(const std::vector<FaceCell>& cells, glm::ivec2 chunk) {
+    int counts[6] = {};
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (const FaceCell& cell : cells) {
+        counts[cell.face]++;
+        for (int value : {cell.face, cell.x, cell.y, cell.z, cell.texture}) {
+            std::uint32_t bits = static_cast<std::uint32_t>(value);
+            for (int byte = 0; byte < 4; byte++) {
+                hash ^= (bits >> (byte * 8)) & 0xffu;
+                hash *= 0x100000001b3ull;
+            }
+        }
+    }
+
+    std::ostringstream line;
+    line << chunk.x << " " << chunk.y;
+    for (int count : counts) line << " " << count;
+    line << " " << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return line.str();
+}
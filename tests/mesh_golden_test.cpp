@@ -0,0 +1,149 @@
+#include "test.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <glm/glm.hpp>
+
+#include "noise/perlin_gen.hpp"
+#include "mesh_coverage.hpp"
+
+/*
+Pins the output of PerlinGen::generate() for a fixed set of chunks.
+
+golden: per chunk and vertex format, the quad count of every face direction
+and an FNV-1a hash of the vertex stream, compared against
+tests/data/mesh_golden.txt. Any change to the noise, the culling, the merge
+order or the vertex layouts shows up here; if it is intended, regenerate the
+file with voxel_tests mesh_golden --update-golden and review its diff.
+
+baseline_coverage: the block faces the Float mesh covers, with flowers
+counted as grass, must be those of the Mask2D/Used2D mesher this one
+replaced, recorded in tests/data/mesh_coverage.txt by
+tests/baseline_coverage.cpp. Faces a neighboring chunk hides are left out,
+the original mesher did not cull them. --update-golden leaves this file
+alone; it only changes if the original mesher's terrain does.
+
+exposed_area: independent of the golden data. Every exposed block face,
+found by sampling the terrain block by block, must be covered exactly once,
+so the merged quads of each direction have the same total area as the
+exposed faces of that direction.
+*/
+
+static const char* GOLDEN_FILE = "mesh_golden.txt";
+static const char* COVERAGE_FILE = "mesh_coverage.txt";
+
+static std::uint64_t fnv1a(const void* data, std::size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (std::size_t i = 0; i < bytes; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/**
+ * One line of the golden file: format, chunk, quads per direction, hash.
+ */
+static std::string describeMesh(VertexFormat format, glm::ivec2 chunk) {
+    ChunkMesh mesh = PerlinGen::generate(TERRAIN_SCALE, chunk.x, chunk.y, format);
+    std::ostringstream line;
+    line << (format == VertexFormat::Packed ? "packed" : "float") << " " << chunk.x << " "
+         << chunk.y;
+    for (int face = 0; face < FACE_COUNT; face++) line << " " << mesh.faceQuadCount[face];
+    line << " " << std::hex << std::setw(16) << std::setfill('0')
+         << fnv1a(mesh.data(), mesh.byteSize());
+    return line.str();
+}
+
+TEST(mesh_golden, matches_checked_in_meshes) {
+    std::vector<std::string> lines;
+    for (VertexFormat format : {VertexFormat::Float, VertexFormat::Packed}) {
+        for (glm::ivec2 chunk : GOLDEN_CHUNKS) lines.push_back(describeMesh(format, chunk));
+    }
+
+    std::string path = testDataPath(GOLDEN_FILE);
+    if (updateGolden()) {
+        std::ofstream out(path);
+        out << "# format chunk_x chunk_z quads(+x -x +y -y +z -z) fnv1a64(vertices)\n";
+        for (const std::string& line : lines) out << line << "\n";
+        CHECK(static_cast<bool>(out));
+        std::cout << "wrote " << path << "\n";
+        return;
+    }
+
+    std::ifstream in(path);
+    CHECK(static_cast<bool>(in));
+    std::vector<std::string> expected;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line[0] != '#') expected.push_back(line);
+    }
+    CHECK_EQ(expected.size(), lines.size());
+    for (std::size_t i = 0; i < std::min(expected.size(), lines.size()); i++) {
+        CHECK_EQ(lines[i], expected[i]);
+    }
+}
+
+TEST(mesh_golden, baseline_coverage) {
+    std::ifstream in(testDataPath(COVERAGE_FILE));
+    CHECK(static_cast<bool>(in));
+    std::vector<std::string> expected;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line[0] != '#') expected.push_back(line);
+    }
+
+    std::size_t count = sizeof(GOLDEN_CHUNKS) / sizeof(GOLDEN_CHUNKS[0]);
+    CHECK_EQ(expected.size(), count);
+    for (std::size_t i = 0; i < std::min(expected.size(), count); i++) {
+        glm::ivec2 chunk = GOLDEN_CHUNKS[i];
+        ChunkMesh mesh = PerlinGen::generate(TERRAIN_SCALE, chunk.x, chunk.y);
+        CHECK_EQ(describeCoverage(faceCoverage(mesh.vertices, QUAD_VERTICES, chunk), chunk),
+                 expected[i]);
+    }
+}
+
+TEST(mesh_golden, exposed_area) {
+    // neighbor offsets in Face order
+    const glm::ivec3 normals[FACE_COUNT] = {
+        {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1},
+    };
+
+    for (glm::ivec2 chunk : GOLDEN_CHUNKS) {
+        long long exposed[FACE_COUNT] = {};
+        for (int i = 0; i < CHUNK_WIDTH; i++) {
+            for (int j = 0; j < CHUNK_LENGTH; j++) {
+                int x = chunk.x * CHUNK_WIDTH + i;
+                int z = chunk.y * CHUNK_LENGTH + j;
+                for (int y = 0; y < CHUNK_HEIGHT; y++) {
+                    if (!isSolid(x, y, z)) continue;
+                    for (int face = 0; face < FACE_COUNT; face++) {
+                        glm::ivec3 n = normals[face];
+                        if (!isSolid(x + n.x, y + n.y, z + n.z)) exposed[face]++;
+                    }
+                }
+            }
+        }
+
+        ChunkMesh mesh = PerlinGen::generate(TERRAIN_SCALE, chunk.x, chunk.y);
+        for (int face = 0; face < FACE_COUNT; face++) {
+            double area = 0.0;
+            std::uint32_t first = mesh.faceFirstQuad[face];
+            for (std::uint32_t q = first; q < first + mesh.faceQuadCount[face]; q++) {
+                const Vertex* corners = &mesh.vertices[q * QUAD_VERTICES];
+                glm::vec3 edgeA = corners[1].position - corners[0].position;
+                glm::vec3 edgeB = corners[3].position - corners[0].position;
+                area += glm::length(glm::cross(edgeA, edgeB));
+            }
+            CHECK_EQ(static_cast<long long>(area + 0.5), exposed[face]);
+        }
+
+        ChunkMesh packed =
+            PerlinGen::generate(TERRAIN_SCALE, chunk.x, chunk.y, VertexFormat::Packed);
+        CHECK_EQ(packed.vertexCount(), mesh.vertexCount());
+    }
+}
@@ -0,0 +1,66 @@
+#include "test.hpp"
+#include "chunk_fixture.hpp"
+
+static constexpr int RADIUS = 3;
+static constexpr int CHUNKS = (2 * RADIUS + 1) * (2 * RADIUS + 1);
+
+static long long measured(const ChunkManager& chunkManager, PipelineStage stage) {
+    return chunkManager.getStageLatency(stage).count();
+}
+
+TEST(pipeline_latency, stages_are_stamped_once_per_chunk) {
+    ChunkManager chunkManager(std::make_unique<NullBackend>());
+    loadAround(chunkManager, 0, 0, RADIUS);
+    CHECK_EQ(measured(chunkManager, PipelineStage::QueueWait), CHUNKS);
+    CHECK_EQ(measured(chunkManager, PipelineStage::Generation), CHUNKS);
+    CHECK_EQ(measured(chunkManager, PipelineStage::UploadWait), CHUNKS);
+    CHECK_EQ(measured(chunkManager, PipelineStage::Upload), CHUNKS);
+    CHECK_EQ(measured(chunkManager, PipelineStage::Ready), CHUNKS);
+    // nothing drawn yet
+    CHECK_EQ(measured(chunkManager, PipelineStage::DrawWait), 0);
+    CHECK_EQ(measured(chunkManager, PipelineStage::Visible), 0);
+
+    // the first pass drawing a chunk stamps it, later passes do not
+    chunkManager.render(noShader(), topDownView(RADIUS), TOP_DOWN_CAMERA);
+    CHECK_EQ(chunkManager.getTerrainStats().chunksDrawn, CHUNKS);
+    CHECK_EQ(measured(chunkManager, PipelineStage::DrawWait), CHUNKS);
+    CHECK_EQ(measured(chunkManager, PipelineStage::Visible), CHUNKS);
+    chunkManager.render(noShader(), topDownView(RADIUS), TOP_DOWN_CAMERA);
+    CHECK_EQ(measured(chunkManager, PipelineStage::Visible), CHUNKS);
+
+    // a whole span is never shorter than its first part
+    CHECK(chunkManager.getStageLatency(PipelineStage::Visible).max() >=
+          chunkManager.getStageLatency(PipelineStage::DrawWait).max());
+    CHECK(chunkManager.getStageLatency(PipelineStage::Ready).max() >=
+          chunkManager.getStageLatency(PipelineStage::Upload).max());
+    chunkManager.shutdown();
+}
+
+TEST(pipeline_latency, cache_hits_are_not_measured_again) {
+    ChunkManager chunkManager(std::make_unique<NullBackend>());
+    loadAround(chunkManager, 0, 0, RADIUS);
+    chunkManager.render(noShader(), topDownView(RADIUS), TOP_DOWN_CAMERA);
+
+    // out past the unload margin and back, the new chunks are never drawn
+    loadAround(chunkManager, 50, 0, RADIUS);
+    loadAround(chunkManager, 0, 0, RADIUS);
+    CHECK_EQ(chunkManager.getCacheStats().hits, static_cast<long long>(CHUNKS));
+    CHECK_EQ(measured(chunkManager, PipelineStage::Ready), 2 * CHUNKS);
+
+    chunkManager.render(noShader(), topDownView(RADIUS), TOP_DOWN_CAMERA);
+    CHECK_EQ(chunkManager.getTerrainStats().chunksDrawn, CHUNKS);
+    CHECK_EQ(measured(chunkManager, PipelineStage::Visible), CHUNKS);
+    CHECK_EQ(measured(chunkManager, PipelineStage::DrawWait), CHUNKS);
+
+    PipelineCounters counters = chunkManager.getPipelineCounters();
+    CHECK(counters.resident >= CHUNKS);
+    CHECK(counters.evicted >= CHUNKS);
+
+    chunkManager.clear();
+    CHECK_EQ(chunkManager.getPipelineCounters().resident, 0);
+    chunkManager.resetStageLatency();
+    for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++) {
+        CHECK_EQ(measured(chunkManager, static_cast<PipelineStage>(stage)), 0);
+    }
+    chunkManager.shutdown();
+}
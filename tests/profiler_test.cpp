@@ -0,0 +1,210 @@
+#include "test.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "utils/profiler.hpp"
+
+/*
+The profiler is a process wide singleton that other suites record into as
+well, so every test works on a track of its own: a fresh thread with a unique
+name, or a track from addTrack().
+*/
+
+static const TrackSnapshot* findTrack(const std::vector<TrackSnapshot>& tracks,
+                                      const std::string& name) {
+    for (const TrackSnapshot& track : tracks) {
+        if (track.name == name) return &track;
+    }
+    return nullptr;
+}
+
+static void onThread(const char* name, void (*run)()) {
+    std::thread thread([name, run] {
+        Profiler::get().setThreadName(name);
+        run();
+    });
+    thread.join();
+}
+
+#if VOXEL_PROFILING
+TEST(profiler, zones_record_their_nesting) {
+    onThread("profiler_test zones", [] {
+        PROFILE_ZONE("outer");
+        {
+            PROFILE_ZONE("middle");
+            { PROFILE_ZONE("inner"); }
+        }
+        { PROFILE_ZONE("sibling"); }
+    });
+
+    std::vector<TrackSnapshot> tracks = Profiler::get().snapshot(0, Profiler::now());
+    const TrackSnapshot* track = findTrack(tracks, "profiler_test zones");
+    CHECK(track != nullptr);
+    if (track == nullptr) return;
+
+    // zones are recorded as they close, innermost first
+    CHECK_EQ(track->events.size(), std::size_t(4));
+    if (track->events.size() != 4) return;
+    const ProfileEvent& inner = track->events[0];
+    const ProfileEvent& middle = track->events[1];
+    const ProfileEvent& sibling = track->events[2];
+    const ProfileEvent& outer = track->events[3];
+    CHECK_EQ(std::string(inner.name), std::string("inner"));
+    CHECK_EQ(std::string(outer.name), std::string("outer"));
+    CHECK_EQ(inner.depth, 2);
+    CHECK_EQ(middle.depth, 1);
+    CHECK_EQ(sibling.depth, 1);
+    CHECK_EQ(outer.depth, 0);
+    CHECK(outer.startNs <= middle.startNs && middle.startNs <= inner.startNs);
+    CHECK(inner.endNs <= middle.endNs && middle.endNs <= sibling.startNs);
+    CHECK(sibling.endNs <= outer.endNs);
+}
+#endif
+
+TEST(profiler, snapshot_keeps_overlapping_events) {
+    onThread("profiler_test window", [] {
+        Profiler::get().record("before", 100, 200, 0);
+        Profiler::get().record("across_start", 250, 350, 0);
+        Profiler::get().record("inside", 400, 500, 0);
+        Profiler::get().record("across_end", 550, 650, 0);
+        Profiler::get().record("after", 700, 800, 0);
+    });
+
+    std::vector<TrackSnapshot> tracks = Profiler::get().snapshot(300, 600);
+    const TrackSnapshot* track = findTrack(tracks, "profiler_test window");
+    CHECK(track != nullptr);
+    if (track == nullptr) return;
+    std::vector<std::string> names;
+    for (const ProfileEvent& event : track->events) names.push_back(event.name);
+    CHECK(names == std::vector<std::string>({"across_start", "inside", "across_end"}));
+
+    // windows are inclusive at both ends
+    tracks = Profiler::get().snapshot(200, 250);
+    track = findTrack(tracks, "profiler_test window");
+    CHECK(track != nullptr && track->events.size() == 2);
+}
+
+TEST(profiler, rings_keep_the_newest_events) {
+    onThread("profiler_test ring", [] {
+        for (std::size_t i = 0; i < Profiler::TRACK_CAPACITY + 10; i++) {
+            long long time = static_cast<long long>(i);
+            Profiler::get().record("event", time, time, 0);
+        }
+    });
+
+    std::vector<TrackSnapshot> tracks = Profiler::get().snapshot(0, Profiler::now());
+    const TrackSnapshot* track = findTrack(tracks, "profiler_test ring");
+    CHECK(track != nullptr);
+    if (track == nullptr) return;
+    CHECK_EQ(track->events.size(), Profiler::TRACK_CAPACITY);
+    // oldest first, the first ten were overwritten
+    bool ordered = true;
+    for (std::size_t i = 0; i < track->events.size(); i++) {
+        ordered = ordered && track->events[i].startNs == static_cast<long long>(i + 10);
+    }
+    CHECK(ordered);
+}
+
+TEST(profiler, exited_threads_hand_their_tracks_on) {
+    // five generations of a resized pool, two workers each
+    for (int generation = 0; generation < 5; generation++) {
+        std::thread first([] {
+            Profiler::get().setThreadName("profiler_test reused");
+            Profiler::get().record("work", 1000, 1001, 0);
+        });
+        std::thread second([] {
+            Profiler::get().setThreadName("profiler_test reused");
+            Profiler::get().record("work", 1000, 1001, 0);
+        });
+        first.join();
+        second.join();
+    }
+
+    int lanes = 0;
+    std::size_t events = 0;
+    for (const TrackSnapshot& track : Profiler::get().snapshot(0, Profiler::now())) {
+        if (track.name != "profiler_test reused") continue;
+        lanes++;
+        events += track.events.size();
+    }
+    // at most one track per thread alive at the same time, none lost
+    CHECK(lanes >= 1 && lanes <= 2);
+    CHECK_EQ(events, std::size_t(10));
+
+    // a thread of another name never takes them over
+    onThread("profiler_test other", [] { Profiler::get().record("work", 1000, 1001, 0); });
+    std::vector<TrackSnapshot> tracks = Profiler::get().snapshot(0, Profiler::now());
+    const TrackSnapshot* other = findTrack(tracks, "profiler_test other");
+    CHECK(other != nullptr && other->events.size() == 1);
+}
+
+TEST(profiler, added_tracks) {
+    int named = Profiler::get().addTrack("profiler_test added");
+    int unnamed = Profiler::get().addTrack("");
+    CHECK(named != unnamed);
+    Profiler::get().recordOn(named, {"gpu", 10, 20, 0});
+
+    std::vector<TrackSnapshot> tracks = Profiler::get().snapshot(0, 30);
+    const TrackSnapshot* track = findTrack(tracks, "profiler_test added");
+    CHECK(track != nullptr && track->events.size() == 1);
+    // unnamed tracks are numbered by their position
+    CHECK(findTrack(tracks, "Thread " + std::to_string(unnamed + 1)) != nullptr);
+}
+
+TEST(profiler, keeps_recent_frames) {
+    for (std::size_t i = 0; i < Profiler::FRAME_HISTORY + 5; i++) Profiler::get().markFrame();
+    long long after = Profiler::now();
+
+    std::vector<long long> frames = Profiler::get().getFrames();
+    CHECK_EQ(frames.size(), Profiler::FRAME_HISTORY);
+    bool ordered = true;
+    for (std::size_t i = 1; i < frames.size(); i++) ordered = ordered && frames[i - 1] <= frames[i];
+    CHECK(ordered);
+    CHECK(frames.back() <= after);
+}
+
+TEST(profiler, writes_chrome_trace) {
+    onThread("profiler_test \"trace\"", [] {
+        long long start = Profiler::now();
+        Profiler::get().record("quoted \"zone\"", start, start + 1500, 0);
+    });
+
+    const std::string file = "profiler_test_trace.json";
+    CHECK(Profiler::get().writeChromeTrace(file));
+    std::ifstream in(file);
+    std::stringstream trace;
+    trace << in.rdbuf();
+    const std::string text = trace.str();
+    std::remove(file.c_str());
+
+    CHECK_EQ(text.rfind("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n", 0), std::size_t(0));
+    CHECK(text.size() >= 4 && text.compare(text.size() - 4, 4, "\n]}\n") == 0);
+    // names are escaped, durations are in microseconds
+    CHECK(text.find("\"args\": {\"name\": \"profiler_test \\\"trace\\\"\"}") != std::string::npos);
+    CHECK(text.find("{\"name\": \"quoted \\\"zone\\\"\", \"ph\": \"X\"") != std::string::npos);
+    CHECK(text.find("\"dur\": 1.500}") != std::string::npos);
+
+    // braces balance outside of strings
+    int open = 0;
+    bool inString = false;
+    bool balanced = true;
+    for (std::size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (inString) {
+            if (c == '\\') i++;
+            else if (c == '"') inString = false;
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            open++;
+        } else if (c == '}' || c == ']') {
+            balanced = balanced && --open >= 0;
+        }
+    }
+    CHECK(balanced && open == 0 && !inString);
+
+    CHECK(!Profiler::get().writeChromeTrace("missing_directory/trace.json"));
+}
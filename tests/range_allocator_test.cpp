@@ -0,0 +1,163 @@
+#include "test.hpp"
+
+#include <map>
+
+#include "render/range_allocator.hpp"
+
+static constexpr std::uint32_t BLOCK = RangeAllocator::BLOCK_VERTICES;
+
+TEST(range_allocator, rounds_to_blocks) {
+    RangeAllocator ranges(16 * BLOCK);
+    int a = ranges.allocate(1);
+    int b = ranges.allocate(BLOCK + 1);
+    CHECK_EQ(ranges.get(a).first, 0u);
+    CHECK_EQ(ranges.get(a).count, 1u);
+    CHECK_EQ(ranges.get(b).first, BLOCK);
+    CHECK_EQ(ranges.pageUsed(0), 3 * BLOCK);
+    CHECK_EQ(ranges.largestFreeRange(0), 13 * BLOCK);
+}
+
+TEST(range_allocator, picks_the_best_fitting_range) {
+    RangeAllocator ranges(16 * BLOCK);
+    // blocks: a a | b | c c c | d | rest
+    int a = ranges.allocate(2 * BLOCK);
+    ranges.allocate(BLOCK);
+    int c = ranges.allocate(3 * BLOCK);
+    ranges.allocate(BLOCK);
+    ranges.allocate(9 * BLOCK);
+    CHECK_EQ(ranges.pageUsed(0), 16 * BLOCK);
+    ranges.release(a);
+    ranges.release(c);
+
+    // free ranges of 2 and 3 blocks, 2 blocks go into the first
+    int fits = ranges.allocate(2 * BLOCK);
+    CHECK_EQ(ranges.get(fits).page, 0);
+    CHECK_EQ(ranges.get(fits).first, 0u);
+    int fitsThree = ranges.allocate(3 * BLOCK);
+    CHECK_EQ(ranges.get(fitsThree).first, 3 * BLOCK);
+    CHECK_EQ(ranges.pageCount(), 1);
+}
+
+TEST(range_allocator, adds_pages_when_nothing_fits) {
+    RangeAllocator ranges(4 * BLOCK);
+    ranges.allocate(3 * BLOCK);
+    int second = ranges.allocate(2 * BLOCK);
+    CHECK_EQ(ranges.pageCount(), 2);
+    CHECK_EQ(ranges.get(second).page, 1);
+
+    // larger than a page, gets a page of its own size
+    int large = ranges.allocate(10 * BLOCK + 5);
+    CHECK_EQ(ranges.pageCount(), 3);
+    CHECK_EQ(ranges.pageCapacity(2), 11 * BLOCK);
+    CHECK_EQ(ranges.get(large).first, 0u);
+
+    // the single free block of page 0 is the best fit
+    int small = ranges.allocate(BLOCK);
+    CHECK_EQ(ranges.get(small).page, 0);
+}
+
+TEST(range_allocator, release_coalesces_neighbors) {
+    RangeAllocator ranges(8 * BLOCK);
+    int handles[8];
+    for (int& handle : handles) handle = ranges.allocate(BLOCK);
+    CHECK_EQ(ranges.largestFreeRange(0), 0u);
+
+    // free 1, 3 and 2 in that order: 2 joins both neighbors
+    ranges.release(handles[1]);
+    ranges.release(handles[3]);
+    CHECK_EQ(ranges.largestFreeRange(0), BLOCK);
+    ranges.release(handles[2]);
+    CHECK_EQ(ranges.largestFreeRange(0), 3 * BLOCK);
+
+    // the merged range is used as a whole
+    int merged = ranges.allocate(3 * BLOCK);
+    CHECK_EQ(ranges.get(merged).first, BLOCK);
+    CHECK_EQ(ranges.pageCount(), 1);
+
+    ranges.release(merged);
+    for (int i : {0, 4, 5, 6, 7}) ranges.release(handles[i]);
+    CHECK_EQ(ranges.largestFreeRange(0), 8 * BLOCK);
+    CHECK_EQ(ranges.pageUsed(0), 0u);
+    CHECK_EQ(ranges.allocationCount(), 0);
+}
+
+TEST(range_allocator, reuses_handles) {
+    RangeAllocator ranges(8 * BLOCK);
+    int a = ranges.allocate(BLOCK);
+    ranges.allocate(BLOCK);
+    ranges.release(a);
+    CHECK_EQ(ranges.get(a).page, -1);
+    CHECK_EQ(ranges.allocate(BLOCK), a);
+    CHECK_EQ(ranges.allocationCount(), 2);
+}
+
+TEST(range_allocator, compacts_scattered_pages) {
+    RangeAllocator ranges(32 * BLOCK);
+    std::vector<int> handles;
+    for (int i = 0; i < 16; i++) handles.push_back(ranges.allocate(BLOCK + i));
+    // every other allocation freed leaves single block holes
+    for (int i = 0; i < 16; i += 2) ranges.release(handles[i]);
+    CHECK_EQ(ranges.mostFragmentedPage(0.5f), 0);
+
+    std::map<int, std::uint32_t> counts;
+    for (int i = 1; i < 16; i += 2) counts[handles[i]] = ranges.get(handles[i]).count;
+
+    std::uint32_t previousTo = 0;
+    int moves = 0;
+    std::uint32_t end = ranges.compact(0, [&](int handle, std::uint32_t from, std::uint32_t to,
+                                              std::uint32_t count) {
+        CHECK(to <= from);
+        CHECK(moves == 0 || to > previousTo);
+        CHECK_EQ(count, counts[handle]);
+        previousTo = to;
+        moves++;
+    });
+    CHECK_EQ(moves, 8);
+
+    // back to back in their old order, one free range after them
+    std::uint32_t cursor = 0;
+    for (int i = 1; i < 16; i += 2) {
+        const ArenaAllocation& allocation = ranges.get(handles[i]);
+        CHECK_EQ(allocation.first, cursor);
+        CHECK_EQ(allocation.count, counts[handles[i]]);
+        cursor += RangeAllocator::roundToBlocks(allocation.count);
+    }
+    CHECK_EQ(end, cursor);
+    CHECK_EQ(ranges.largestFreeRange(0), 32 * BLOCK - end);
+    CHECK_EQ(ranges.mostFragmentedPage(0.0f), -1);
+
+    // releases after compaction still coalesce
+    for (int i = 1; i < 16; i += 2) ranges.release(handles[i]);
+    CHECK_EQ(ranges.largestFreeRange(0), 32 * BLOCK);
+}
+
+TEST(range_allocator, leaves_tidy_or_full_pages_alone) {
+    RangeAllocator ranges(64 * BLOCK);
+    // two holes in an almost full page: too little free space to bother
+    std::vector<int> handles;
+    for (int i = 0; i < 64; i++) handles.push_back(ranges.allocate(BLOCK));
+    ranges.release(handles[10]);
+    ranges.release(handles[20]);
+    CHECK_EQ(ranges.mostFragmentedPage(0.0f), -1);
+
+    // free space in one piece is not fragmented
+    RangeAllocator tidy(64 * BLOCK);
+    tidy.allocate(8 * BLOCK);
+    CHECK_EQ(tidy.mostFragmentedPage(0.0f), -1);
+}
+
+TEST(range_allocator, reset_drops_pages_and_handles) {
+    RangeAllocator ranges(8 * BLOCK);
+    for (int i = 0; i < 12; i++) ranges.allocate(BLOCK);
+    CHECK_EQ(ranges.pageCount(), 2);
+
+    // a vertex format switch: same bytes per page, twice the vertices
+    ranges.reset(16 * BLOCK);
+    CHECK_EQ(ranges.pageCount(), 0);
+    CHECK_EQ(ranges.allocationCount(), 0);
+    int first = ranges.allocate(12 * BLOCK);
+    CHECK_EQ(first, 0);
+    CHECK_EQ(ranges.pageCount(), 1);
+    CHECK_EQ(ranges.pageCapacity(0), 16 * BLOCK);
+    CHECK_EQ(ranges.get(first).first, 0u);
+}
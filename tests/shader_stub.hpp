@@ -0,0 +1,9 @@
+#pragma once
+
+/*
+GL-free stand-in for render/shader.h in voxel_tests. voxel_core only passes
+Shader references through to the backend and never completes the type, the
+GL Shader is not linked into the tests, and NullBackend never reads the
+shader, so an empty class is enough to hand the passes a real object.
+*/
+class Shader {};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+Minimal test registry for voxel_tests, no framework needed.
+
+    TEST(suite, name) {
+        CHECK(condition);
+        CHECK_EQ(actual, expected);
+    }
+
+Tests register themselves at static initialization. voxel_tests runs every
+suite, or only the suites named on the command line; ctest runs each suite as
+its own test (see CMakeLists.txt). A failed check reports its file and line
+and the test carries on, so one run shows every mismatch.
+*/
+
+struct TestCase {
+    const char* suite;
+    const char* name;
+    void (*run)();
+};
+
+std::vector<TestCase>& testRegistry();
+/** Checks failed so far in the running test */
+int& testFailures();
+/** Set by --update-golden, golden data tests rewrite their files instead of comparing */
+bool updateGolden();
+/** Directory of the checked-in test data, tests/data in the source tree */
+std::string testDataPath(const std::string& file);
+
+struct TestRegistrar {
+    TestRegistrar(const char* suite, const char* name, void (*run)()) {
+        testRegistry().push_back({suite, name, run});
+    }
+};
+
+#define TEST(suite, name)                                                        \
+    static void suite##_##name();                                                \
+    static TestRegistrar suite##_##name##_registrar(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition \
+                      << ") failed\n";                                        \
+            testFailures()++;                                                 \
+        }                                                                     \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                   \
+    do {                                                                             \
+        auto&& checkActual = (actual);                                               \
+        auto&& checkExpected = (expected);                                           \
+        if (!(checkActual == checkExpected)) {                                       \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_EQ(" #actual ", " \
+                      #expected ") failed: " << checkActual << " != "                \
+                      << checkExpected << "\n";                                      \
+            testFailures()++;                                                        \
+        }                                                                            \
+    } while (0)
@@ -0,0 +1,69 @@
+#include "test.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+/*
+voxel_tests [SUITE...] [--update-golden]
+
+Runs the registered tests, all of them or those of the named suites, and
+exits non-zero if any check failed. --update-golden makes golden data tests
+rewrite their files under tests/data from the current output, for changes
+that are meant to alter it; review the diff before committing.
+*/
+
+static bool updatingGolden = false;
+
+std::vector<TestCase>& testRegistry() {
+    static std::vector<TestCase> registry;
+    return registry;
+}
+
+int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+bool updateGolden() {
+    return updatingGolden;
+}
+
+std::string testDataPath(const std::string& file) {
+    return std::string(VOXEL_TEST_DATA_DIR) + "/" + file;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> suites;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--update-golden") == 0) {
+            updatingGolden = true;
+        } else {
+            suites.push_back(argv[i]);
+        }
+    }
+
+    int run = 0;
+    int failed = 0;
+    for (const TestCase& test : testRegistry()) {
+        if (!suites.empty() &&
+            std::find(suites.begin(), suites.end(), test.suite) == suites.end()) {
+            continue;
+        }
+        testFailures() = 0;
+        test.run();
+        run++;
+        if (testFailures() > 0) {
+            failed++;
+            std::cout << "FAIL " << test.suite << "." << test.name << "\n";
+        } else {
+            std::cout << "ok   " << test.suite << "." << test.name << "\n";
+        }
+    }
+
+    if (run == 0) {
+        std::cerr << "no tests matched\n";
+        return 1;
+    }
+    std::cout << run - failed << "/" << run << " tests passed\n";
+    return failed > 0 ? 1 : 0;
+}
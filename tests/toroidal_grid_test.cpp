@@ -0,0 +1,88 @@
+#include "test.hpp"
+
+#include <set>
+#include <utility>
+
+#include "world/toroidal_grid.hpp"
+
+TEST(toroidal_grid, square_maps_to_distinct_slots) {
+    ToroidalGrid<int> grid(5);
+    // any 5 x 5 window, including negative coordinates
+    for (glm::ivec2 origin : {glm::ivec2(0, 0), glm::ivec2(-3, 7), glm::ivec2(-101, -58)}) {
+        std::set<int> slots;
+        for (int x = origin.x; x < origin.x + 5; x++) {
+            for (int z = origin.y; z < origin.y + 5; z++) {
+                int slot = grid.slot(x, z);
+                CHECK(slot >= 0 && slot < grid.capacity());
+                slots.insert(slot);
+            }
+        }
+        CHECK_EQ(static_cast<int>(slots.size()), grid.capacity());
+    }
+}
+
+TEST(toroidal_grid, find_checks_the_stored_coordinate) {
+    ToroidalGrid<int> grid(4);
+    grid.insert(1, 2) = 12;
+    CHECK_EQ(grid.count(), 1);
+    CHECK(grid.find(1, 2) != nullptr);
+    CHECK_EQ(*grid.find(1, 2), 12);
+    // same cell, different coordinate
+    CHECK_EQ(grid.slot(5, -2), grid.slot(1, 2));
+    CHECK(grid.find(5, -2) == nullptr);
+    CHECK(grid.find(0, 0) == nullptr);
+
+    grid.erase(grid.slot(1, 2));
+    CHECK_EQ(grid.count(), 0);
+    CHECK(grid.find(1, 2) == nullptr);
+    grid.insert(5, -2) = 52;
+    CHECK_EQ(*grid.find(5, -2), 52);
+    CHECK(grid.coord(grid.slot(5, -2)) == glm::ivec2(5, -2));
+}
+
+TEST(toroidal_grid, window_slides_without_collisions) {
+    // a 3 x 3 window walking along x: the column leaving frees the cells the
+    // column entering needs
+    ToroidalGrid<int> grid(3);
+    for (int x = -1; x <= 1; x++)
+        for (int z = -1; z <= 1; z++) grid.insert(x, z) = x * 10 + z;
+
+    for (int center = 1; center <= 20; center++) {
+        for (int z = -1; z <= 1; z++) {
+            int leaving = center - 2;
+            grid.erase(grid.slot(leaving, z));
+            grid.insert(center + 1, z) = (center + 1) * 10 + z;
+        }
+        CHECK_EQ(grid.count(), 9);
+        for (int x = center - 1; x <= center + 1; x++) {
+            for (int z = -1; z <= 1; z++) {
+                const int* value = grid.find(x, z);
+                CHECK(value != nullptr && *value == x * 10 + z);
+            }
+        }
+    }
+}
+
+TEST(toroidal_grid, resize_keeps_values) {
+    ToroidalGrid<int> grid(3);
+    for (int x = 4; x <= 6; x++)
+        for (int z = -7; z <= -5; z++) grid.insert(x, z) = x * 100 + z;
+
+    for (int side : {7, 4, 3}) {
+        grid.resize(side);
+        CHECK_EQ(grid.side(), side);
+        CHECK_EQ(grid.count(), 9);
+        int visited = 0;
+        grid.forEach([&](int slot, int& value) {
+            glm::ivec2 c = grid.coord(slot);
+            CHECK_EQ(value, c.x * 100 + c.y);
+            CHECK_EQ(slot, grid.slot(c.x, c.y));
+            visited++;
+        });
+        CHECK_EQ(visited, 9);
+    }
+
+    grid.clear();
+    CHECK_EQ(grid.count(), 0);
+    CHECK(grid.find(5, -6) == nullptr);
+}